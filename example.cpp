@@ -11,6 +11,12 @@ TEST(TEST_CASE) {
     ASSERT_LT(20, 10)
     ASSERT_GEQ(20, 20)
 
+    ASSERT_EQ(std::filesystem::path("gech"), std::filesystem::path("savort"))
+}
+
+TEST(TEST_CASE_2) {
+    ASSERT_LEQ(10, 20)
+
     std::cout << "\ndata:\n"
               << TEST_DATA.string_data.str();
 }
@@ -0,0 +1,16 @@
+#define TEST_TRACK_ALLOC
+#include "include/gechtest.hpp"
+
+
+// failing cases allocate their messages, none of which is a leak.
+PROPERTY(TEST_PROPERTY, gech::gen::integer(0, 100)) {
+    const auto& [value] = args;
+
+    ASSERT_LT(value, 50)
+}
+
+FUZZ_TEST(TEST_FUZZ_CASE, const std::uint8_t*, std::size_t size) {
+    ASSERT_GT(size, std::size_t(0))
+}
+
+TEST_MAIN
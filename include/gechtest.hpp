@@ -13,12 +13,41 @@
 #define GECHTEST_GECHTEST_HPP
 
 #include <iostream>
+#include <sstream>
+#include <fstream>
+#include <string>
 #include <vector>
+#include <map>
+#include <unordered_map>
+#include <deque>
 #include <chrono>
-
-#ifdef TEST_GET_AS_STRING
-    #include <sstream>
-#endif
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <array>
+#include <memory>
+#include <type_traits>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <cerrno>
+#include <cmath>
+#include <cctype>
+#include <limits>
+#include <random>
+#include <filesystem>
+#include <coroutine>
+#include <exception>
+#include <queue>
+#include <cstdint>
+#include <charconv>
+#include <optional>
+#include <tuple>
+#include <ranges>
+#include <bit>
+#include <functional>
+#include <utility>
 
 #ifdef __has_include
     #if __has_include(<string_view>)
@@ -36,6 +65,104 @@
     #include <source_location>
 #endif
 
+#if defined(__linux__)
+    #define GECHTEST_HAS_PERF
+    #include <linux/perf_event.h>
+    #include <sys/ioctl.h>
+    #include <sys/syscall.h>
+#endif
+
+// timer behind suite, case and benchmark timings, steady_clock unless
+// GECHTEST_CLOCK_RDTSC or GECHTEST_CLOCK_MONOTONIC_RAW is defined.
+#if defined(GECHTEST_CLOCK_RDTSC) && (defined(__x86_64__) || defined(__i386__))
+    #define GECHTEST_HAS_RDTSC
+    #include <x86intrin.h>
+#endif
+
+#if defined(GECHTEST_CLOCK_MONOTONIC_RAW) && defined(__linux__)
+    #include <time.h>
+#endif
+
+// vector kernels for range and buffer comparisons, scalar loops otherwise.
+#if defined(__AVX2__)
+    #define GECHTEST_HAS_AVX2
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #define GECHTEST_HAS_SSE2
+#endif
+
+#if defined(GECHTEST_HAS_AVX2) || defined(GECHTEST_HAS_SSE2)
+    #include <immintrin.h>
+#endif
+
+// TEST_TRACK_ALLOC replaces global operator new/delete to find leaked
+// blocks per case, define it in the one translation unit with TEST_MAIN.
+// GECHTEST_TRACK_MALLOC also tracks malloc & co. when linked with
+// -Wl,--wrap=malloc,--wrap=free,--wrap=calloc,--wrap=realloc.
+// a gech::thread allocates into the case that started it, and must be
+// joined before that case ends; plain std::threads are not tracked.
+#ifdef TEST_TRACK_ALLOC
+    #include <new>
+
+    // operator new must stay a real call for its return address to be the allocation site.
+    #ifdef _MSC_VER
+        #include <intrin.h>
+        #define GECHTEST_RETURN_ADDRESS() _ReturnAddress()
+        #define GECHTEST_NOINLINE __declspec(noinline)
+    #else
+        #define GECHTEST_RETURN_ADDRESS() __builtin_return_address(0)
+        #define GECHTEST_NOINLINE __attribute__((noinline))
+    #endif
+
+    #ifdef GECHTEST_TRACK_MALLOC
+        extern "C" void* __real_malloc(std::size_t);
+        extern "C" void* __real_realloc(void*, std::size_t);
+        extern "C" void __real_free(void*);
+    #endif
+
+    #if defined(__unix__) || defined(__APPLE__)
+        #define GECHTEST_HAS_DLADDR
+        #include <dlfcn.h>
+        #include <cxxabi.h>
+    #endif
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+    #define GECHTEST_HAS_FORK
+    #define GECHTEST_HAS_POSIX
+    #include <cstring>
+    #include <unistd.h>
+    #include <poll.h>
+    #include <signal.h>
+    #include <fcntl.h>
+    #include <sys/wait.h>
+#endif
+
+// TEST_FUZZ defines the coverage callbacks FUZZ_TEST() learns from, in the
+// translation unit with TEST_MAIN; the code under test is built with
+// -fsanitize-coverage=trace-pc-guard (clang) or -fsanitize-coverage=trace-pc (gcc).
+#if defined(__clang__)
+    #define GECHTEST_NO_COVERAGE __attribute__((no_sanitize("coverage")))
+#elif defined(__GNUC__) && defined(__has_attribute)
+    #if __has_attribute(no_sanitize_coverage)
+        #define GECHTEST_NO_COVERAGE __attribute__((no_sanitize_coverage))
+    #endif
+#endif
+
+#ifndef GECHTEST_NO_COVERAGE
+    #define GECHTEST_NO_COVERAGE
+#endif
+
+// fuzz inputs get a buffer of their exact size, so reads past it are reported.
+#if defined(__SANITIZE_ADDRESS__)
+    #define GECHTEST_HAS_ASAN
+#elif defined(__has_feature)
+    #if __has_feature(address_sanitizer)
+        #define GECHTEST_HAS_ASAN
+    #endif
+#endif
+
 namespace gech {
     using function_test = void(*)();
 
@@ -64,311 +191,5900 @@ namespace gech {
         test_rc_node() = default; ~test_rc_node() = default;
     };
 
+    // output is built with to_chars straight into the destination string,
+    // no locale, no stream and no temporary per number.
+    template <typename Int>
+    inline void append_number(std::string& text, const Int value) {
+        // the shortest long double still needs room for a 4-digit exponent.
+        char buffer[64];
+        const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value);
+
+        if(error != std::errc{}) {
+            text += '?';
+            return;
+        }
+
+        text.append(buffer, end);
+    }
+
+    inline void append_number(std::string& text, const double value, const int precision) {
+        char buffer[64];
+        const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer), value, std::chars_format::fixed, precision);
+
+        if(error != std::errc{}) {
+            text += '?';
+            return;
+        }
+
+        text.append(buffer, end);
+    }
+
+    enum perf_events {
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        PageFaults,
+        PerfEventCount
+    };
+
+    // hardware counter values of one case (or one benchmark iteration),
+    // unavailable where the kernel or the machine refused that event.
+    class perf_sample {
+    public:
+        static constexpr std::uint64_t unavailable = ~std::uint64_t(0);
+
+        std::array<std::uint64_t, PerfEventCount> values;
+    public:
+        perf_sample() { this->values.fill(unavailable); }
+        ~perf_sample() = default;
+
+        std::uint64_t operator[](const perf_events event) const noexcept {
+            return this->values[event];
+        }
+
+        bool empty() const noexcept {
+            return std::all_of(this->values.begin(), this->values.end(),
+                               [](std::uint64_t value) { return value == unavailable; });
+        }
+
+        // (end - begin) / divisor per event, for per-iteration numbers.
+        static perf_sample delta(const perf_sample& begin, const perf_sample& end, std::uint64_t divisor = 1) noexcept {
+            perf_sample sample;
+
+            for(std::size_t i = 0; i < PerfEventCount; ++i) {
+                if(begin.values[i] != unavailable && end.values[i] != unavailable)
+                    sample.values[i] = (end.values[i] - begin.values[i]) / std::max<std::uint64_t>(divisor, 1);
+            }
+
+            return sample;
+        }
+
+        void print(std::string& text) const {
+            static constexpr const char* labels[PerfEventCount] = {
+                "cycles", "instruction/s", "cache miss/es", "branch miss/es", "page fault/s"
+            };
+
+            for(std::size_t i = 0; i < PerfEventCount; ++i) {
+                text += i == 0 ? "" : ", ";
+                text += labels[i];
+                text += ": ";
+
+                if(this->values[i] == unavailable)
+                    text += '-';
+                else
+                    gech::append_number(text, this->values[i]);
+            }
+        }
+    };
+
+    // per-thread perf_event_open() counters, opened on first use. instruction
+    // counts barely move with noisy neighbours, unlike wall time.
+    class perf_counters {
+    public:
+        std::array<int, PerfEventCount> fds;
+        bool opened = false;
+    public:
+        perf_counters() { this->fds.fill(-1); }
+
+        perf_counters(const perf_counters&) = delete;
+        perf_counters& operator=(const perf_counters&) = delete;
+
+        ~perf_counters() {
+            #ifdef GECHTEST_HAS_PERF
+                for(const auto fd : this->fds) {
+                    if(fd >= 0)
+                        ::close(fd);
+                }
+            #endif
+        }
+
+        void open() {
+            if(this->opened)
+                return;
+
+            this->opened = true;
+
+            #ifdef GECHTEST_HAS_PERF
+                static constexpr std::pair<std::uint32_t, std::uint64_t> events[PerfEventCount] = {
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES },
+                    { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+                    { PERF_TYPE_SOFTWARE, PERF_COUNT_SW_PAGE_FAULTS }
+                };
+
+                for(std::size_t i = 0; i < PerfEventCount; ++i) {
+                    perf_event_attr attr {};
+                    attr.size = sizeof(attr);
+                    attr.type = events[i].first;
+                    attr.config = events[i].second;
+                    attr.disabled = 1;
+                    attr.exclude_kernel = 1;
+                    attr.exclude_hv = 1;
+
+                    this->fds[i] = static_cast<int>(::syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+                }
+            #endif
+        }
+
+        void start() {
+            this->open();
+
+            #ifdef GECHTEST_HAS_PERF
+                for(const auto fd : this->fds) {
+                    if(fd >= 0) {
+                        ::ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+                        ::ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+                    }
+                }
+            #endif
+        }
+
+        perf_sample read() const {
+            perf_sample sample;
+
+            #ifdef GECHTEST_HAS_PERF
+                for(std::size_t i = 0; i < PerfEventCount; ++i) {
+                    std::uint64_t value = 0;
+
+                    if(this->fds[i] >= 0 && ::read(this->fds[i], &value, sizeof(value)) == sizeof(value))
+                        sample.values[i] = value;
+                }
+            #endif
+
+            return sample;
+        }
+
+        perf_sample stop() {
+            #ifdef GECHTEST_HAS_PERF
+                for(const auto fd : this->fds) {
+                    if(fd >= 0)
+                        ::ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+                }
+            #endif
+
+            return this->read();
+        }
+    };
+
+    // time stamp counter, converted to nanoseconds with a ratio measured
+    // against steady_clock the first time it is read. assumes an invariant
+    // tsc, which every x86 of the last decade has.
+    class rdtsc_clock {
+    public:
+        using duration = std::chrono::nanoseconds;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::time_point<rdtsc_clock>;
+
+        static constexpr bool is_steady = true;
+    public:
+        rdtsc_clock() = default; ~rdtsc_clock() = default;
+
+        #ifdef GECHTEST_HAS_RDTSC
+            static time_point now() noexcept {
+                static const double ns_per_tick = calibrate();
+                return time_point(duration(static_cast<rep>(__rdtsc() * ns_per_tick)));
+            }
+
+            static double calibrate() noexcept {
+                const auto started = std::chrono::steady_clock::now();
+                const auto ticks = __rdtsc();
+
+                while(std::chrono::steady_clock::now() - started < std::chrono::milliseconds(10))
+                    ;
+
+                const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                        std::chrono::steady_clock::now() - started).count();
+
+                return static_cast<double>(ns) / static_cast<double>(__rdtsc() - ticks);
+            }
+        #else
+            static time_point now() noexcept {
+                return time_point(std::chrono::duration_cast<duration>(
+                        std::chrono::steady_clock::now().time_since_epoch()));
+            }
+        #endif
+    };
+
+    // CLOCK_MONOTONIC_RAW, steady and untouched by ntp slewing too.
+    class monotonic_raw_clock {
+    public:
+        using duration = std::chrono::nanoseconds;
+        using rep = duration::rep;
+        using period = duration::period;
+        using time_point = std::chrono::time_point<monotonic_raw_clock>;
+
+        static constexpr bool is_steady = true;
+    public:
+        monotonic_raw_clock() = default; ~monotonic_raw_clock() = default;
+
+        static time_point now() noexcept {
+            #if defined(GECHTEST_CLOCK_MONOTONIC_RAW) && defined(CLOCK_MONOTONIC_RAW)
+                timespec at;
+                clock_gettime(CLOCK_MONOTONIC_RAW, &at);
+                return time_point(duration(static_cast<rep>(at.tv_sec) * 1'000'000'000 + at.tv_nsec));
+            #else
+                return time_point(std::chrono::duration_cast<duration>(
+                        std::chrono::steady_clock::now().time_since_epoch()));
+            #endif
+        }
+    };
+
+    #if defined(GECHTEST_CLOCK_RDTSC)
+        using clock = rdtsc_clock;
+    #elif defined(GECHTEST_CLOCK_MONOTONIC_RAW)
+        using clock = monotonic_raw_clock;
+    #else
+        using clock = std::chrono::steady_clock;
+    #endif
+
+    // source_location has no operator==; file names are compared by content
+    // since each translation unit may have its own copy of the literal.
+    inline bool same_location(const std::source_location& a, const std::source_location& b) noexcept {
+        return a.line() == b.line() && a.column() == b.column()
+            && std::string_view(a.file_name()) == std::string_view(b.file_name());
+    }
+
+    // nanoseconds passed since a gech::clock time point.
+    inline std::uint64_t elapsed_ns(const clock::time_point since) noexcept {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - since).count();
+    }
+
     class test_log_node {
     public:
-        unsigned ms_took = 0;
+        std::uint64_t ms_took = 0;
+        perf_sample counters;
         test_results result;
         string data;
+        bool kept = false;
         function_test func;
     public:
         test_log_node() = default; ~test_log_node() = default;
     };
 
-    class test {
+    // chunked store for log nodes with stable addresses. chunks are kept and
+    // reused across clear(), so a long run does not keep going back to the heap.
+    // past cap in-memory nodes the oldest chunk is written to a temporary
+    // file and recycled; at() still reads those back, operator[] does not.
+    template <typename Node, std::size_t ChunkSize = 1024>
+    class log_arena {
+        static_assert(std::is_trivially_copyable_v<Node>, "log_arena spills nodes as raw bytes");
     public:
-        std::uint_least32_t line, column;
+        std::vector<std::unique_ptr<Node[]>> chunks, spare;
 
-        string file_name, function_name;
+        // nodes below first live in the spill file.
+        std::size_t first = 0, count = 0;
 
-        int rc = 0;
+        // most nodes kept in memory, 0 means unbounded.
+        std::size_t cap = 0;
 
-        unsigned errors = 0;
+        std::FILE* spill = nullptr;
 
-        std::vector<test_log_node> infos;
-        std::vector<test_rc_node> rc_infos;
+        // set when the spill file cannot be made or written, the arena then
+        // grows past cap instead of losing nodes.
+        bool unspillable = false;
+    public:
+        class iterator {
+        public:
+            const log_arena* arena;
+            std::size_t index;
+        public:
+            Node& operator*() const noexcept { return (*const_cast<log_arena*>(this->arena))[this->index]; }
+            Node* operator->() const noexcept { return &**this; }
+            iterator& operator++() noexcept { ++this->index; return *this; }
+            bool operator==(const iterator& other) const noexcept { return this->index == other.index; }
+        };
 
-        function_test func;
+        log_arena() = default;
 
-        std::source_location current_location;
+        log_arena(const log_arena&) = delete;
+        log_arena& operator=(const log_arena&) = delete;
 
-        const std::chrono::time_point<
-                std::chrono::_V2::system_clock, std::chrono::duration<
-                        long int, std::ratio<1, 1000000000>>> main_ms = std::chrono::system_clock::now();
+        ~log_arena() {
+            if(this->spill != nullptr)
+                std::fclose(this->spill);
+        }
 
-        #ifdef TEST_GET_AS_STRING
-            std::stringstream string_data;
-        #endif
-    public:
-        test(function_test func) : func(func) {
-            this->fill_infos();
+        std::size_t size() const noexcept {
+            return this->count;
         }
 
-        ~test() {
-            this->assert_rc();
-            this->summary();
+        bool empty() const noexcept {
+            return this->count == 0;
         }
 
-        auto since_time() {
-            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now() - this->main_ms);
+        std::size_t spilled() const noexcept {
+            return this->first;
         }
 
-        void summary() {
-            #ifdef TEST_GET_AS_STRING
-                this->string_data << "\n[SUMMARY]\n"
-                                  << "File: "
-                                  << this->current_location.file_name()
-                                  << '\n'
-                                  << "Error/s: "
-                                  << this->errors
-                                  << '\n'
-                                  << since_time().count()
-                                  << "ns\n";
-            #endif
+        Node& operator[](std::size_t index) noexcept {
+            index -= this->first;
+            return this->chunks[index / ChunkSize][index % ChunkSize];
+        }
 
-            std::cout << "\n[SUMMARY]\n"
-                      << "File: "
-                      << this->current_location.file_name()
-                      << '\n'
-                      << "Error/s: "
-                      << this->errors
-                      << '\n'
-                      << since_time().count()
-                      << "ns\n";
+        Node& back() noexcept {
+            return (*this)[this->count - 1];
         }
 
-        unsigned calculate_time(function_test func) {
-            auto ms = std::chrono::high_resolution_clock::now();
-            func();
-            return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::high_resolution_clock::now() - ms).count();
+        // nullptr once the node has been spilled.
+        Node* find(std::size_t index) noexcept {
+            return index >= this->first && index < this->count ? &(*this)[index] : nullptr;
         }
 
-        void run_tests() {
-            this->infos.back().ms_took = this->calculate_time(this->func);
+        Node at(std::size_t index) {
+            if(index >= this->first)
+                return (*this)[index];
 
-            // for(auto& test : this->infos) {
-            //     if(test.func != nullptr)
-            //         test.ms_took = this->calculate_time(test.func);
-            // }
+            Node node {};
+            std::fseek(this->spill, static_cast<long>(index * sizeof(Node)), SEEK_SET);
+            std::fread(&node, sizeof(Node), 1, this->spill);
+            return node;
         }
 
-        void test_function(function_test test) {
-            gech::test_log_node val;
-            val.func = test;
-            this->infos.push_back(val);
-        }
+        iterator begin() const noexcept { return { this, this->first }; }
+        iterator end() const noexcept { return { this, this->count }; }
 
-        void fill_infos(const std::source_location location = std::source_location::current()) {
-            this->line = location.line();
-            this->column = location.column();
-            this->file_name = location.file_name();
-            this->function_name = location.function_name();
-        }
+        void push_back(const Node& node) {
+            const auto used = this->count - this->first;
 
-        gech::test_log_node put_log(const gech::test_results& result, const string message) noexcept {
-            gech::test_log_node val;
-            val.result = result;
-            val.data = message;
-            this->infos.push_back(val);
-            return val;
-        }
-        void draw_case(const gech::test_log_node& node) {
-            #ifdef TEST_GET_AS_STRING
-                if(node.result == Critical)
-                    this->string_data << "[CRITICAL]: ";
-                else if(node.result == Success)
-                    this->string_data << "[SUCCESS]: ";
+            if(used == this->chunks.size() * ChunkSize) {
+                if(this->cap != 0 && used >= std::max(this->cap, ChunkSize) && !this->unspillable)
+                    this->unspillable = !this->spill_chunk();
+
+                if(this->spare.empty())
+                    this->chunks.push_back(std::make_unique<Node[]>(ChunkSize));
                 else {
-                    this->string_data <<  "[FAILED]: ";
-                    ++this->errors;
+                    this->chunks.push_back(std::move(this->spare.back()));
+                    this->spare.pop_back();
                 }
-            #endif
-
-            if(node.result == Critical)
-                std::cout << "[CRITICAL]: ";
-            else if(node.result == Success)
-                std::cout << "[SUCCESS]: ";
-            else {
-                std::cout << "[FAILED]: ";
-                ++this->errors;
             }
+
+            (*this)[this->count++] = node;
         }
 
-        template <typename... Val>
-        void put(const Val... message) noexcept {
-            auto info = this->infos.back();
+        void clear() noexcept {
+            for(auto& chunk : this->chunks)
+                this->spare.push_back(std::move(chunk));
 
-            this->draw_case(info);
+            this->chunks.clear();
+            this->first = this->count = 0;
+        }
 
-            #ifdef TEST_GET_AS_STRING
-                this->string_data << "("
-                                  << this->current_location.file_name()
-                                  << ", "
-                                  << this->current_location.line()
-                                  << ":"
-                                  << this->current_location.column()
-                                  << ":"
-                                  << info.ms_took
-                                  << "ns"
-                                  << ") ["
-                                  << this->current_location.function_name()
-                                  << "] -> "
-                                  << info.data << '\n';
-            #endif
+        // false, with the chunk still in memory, when it could not be written.
+        bool spill_chunk() {
+            if(this->spill == nullptr)
+                this->spill = std::tmpfile();
 
-            std::cout << "("
-                      << this->current_location.file_name()
-                      << ", "
-                      << this->current_location.line()
-                      << ":"
-                      << this->current_location.column()
-                      << ":"
-                      << info.ms_took
-                      << "ns"
-                      << ") ["
-                      << this->current_location.function_name()
-                      << "] -> "
-                      << info.data << '\n';
-        }
+            if(this->spill == nullptr
+            || std::fseek(this->spill, static_cast<long>(this->first * sizeof(Node)), SEEK_SET) != 0
+            || std::fwrite(this->chunks.front().get(), sizeof(Node), ChunkSize, this->spill) != ChunkSize)
+                return false;
 
-        template <typename Arg1, typename Arg2>
-        void assert(const gech::test_types& type, Arg1& val, Arg2& val2,
-                    const std::source_location location = std::source_location::current()) {
-            this->current_location = location;
-            switch(type) {
-                case Eq:
-                    if(val == val2) {
-                        this->put(this->put_log(Success, "OK").data);
-                        break;
-                    }
+            this->spare.push_back(std::move(this->chunks.front()));
+            this->chunks.erase(this->chunks.begin());
+            this->first += ChunkSize;
+            return true;
+        }
+    };
 
-                    this->put(this->put_log(Error, "Given values are not equal, expected equal").data);
-                    break;
+    class test;
+    class alloc_scope;
 
-                case UnEq:
-                    if(val != val2) {
-                        this->put(this->put_log(Success, "OK").data);
-                        break;
-                    }
+    // one CO_TEST() on an event_loop: the context its assertions go to and
+    // how far it got.
+    class co_case {
+    public:
+        test* context = nullptr;
+        alloc_scope* scope = nullptr;
 
-                    this->put(this->put_log(Error, "Given values are equal, expected not equal").data);
-                    break;
+        // run time on gech::clock, the deadline on the clock the loop waits with.
+        gech::clock::time_point started, ended;
+        std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
 
-                case Gt:
-                    if(val > val2) {
-                        this->put(this->put_log(Success, "OK").data);
-                        break;
-                    }
+        bool finished = false, timed_out = false;
+        std::exception_ptr error;
+    public:
+        co_case() = default; ~co_case() = default;
 
-                    this->put(this->put_log(Error, "Given values are not greater, expected greater").data);
-                    break;
+        void finish(std::exception_ptr error) noexcept {
+            this->finished = true;
+            this->ended = gech::clock::now();
+            this->error = std::move(error);
+        }
+    };
 
-                case Lt:
-                    if(val < val2) {
-                        this->put(this->put_log(Success, "OK").data);
-                        break;
-                    }
+    // frames start suspended; a task awaited by another resumes its caller
+    // when done, the outermost one (a CO_TEST() body) finishes its co_case.
+    class task_promise_base {
+    public:
+        std::coroutine_handle<> continuation;
+        std::exception_ptr error;
+        co_case* owner = nullptr;
+    public:
+        task_promise_base() = default; ~task_promise_base() = default;
 
-                    this->put(this->put_log(Error, "Given values are greater, expected not greater").data);
-                    break;
+        class final_awaiter {
+        public:
+            bool await_ready() const noexcept { return false; }
 
-                case GEq:
-                    if(val >= val2) {
-                        this->put(this->put_log(Success, "OK").data);
-                        break;
-                    }
+            template <typename Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+                auto& promise = handle.promise();
 
-                    this->put(this->put_log(Error, "Given values are not greater or equal, expected greater or equal").data);
-                    break;
+                if(promise.continuation)
+                    return promise.continuation;
 
-                case LEq:
-                    if(val <= val2) {
-                        this->put(this->put_log(Success, "OK").data);
-                        break;
-                    }
+                if(promise.owner != nullptr)
+                    promise.owner->finish(promise.error);
 
-                    this->put(this->put_log(Error, "Given values are greater or equal, expected not greater or equal").data);
+                return std::noop_coroutine();
             }
-        }
 
-        void assert_rc(const std::source_location location = std::source_location::current()) {
-            if(this->rc < 0) {
-                this->put(this->put_log(Critical, "(RC < 0) Deallocating not allocated value").data, location);
-                this->summary();
-                std::abort();
-            }
-        }
+            void await_resume() const noexcept {}
+        };
 
-        template <typename Arg1, typename Arg2>
-        void assert_eq(Arg1 val, Arg2 val2, const std::source_location location = std::source_location::current()) {
-            this->assert(Eq, val, val2, location);
-        }
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+        final_awaiter final_suspend() const noexcept { return {}; }
 
-        template <typename Arg1, typename Arg2>
-        void assert_uneq(Arg1 val, Arg2 val2, const std::source_location location = std::source_location::current()) {
-            this->assert(UnEq, val, val2, location);
+        void unhandled_exception() noexcept {
+            this->error = std::current_exception();
         }
+    };
 
-        template <typename Arg1, typename Arg2>
-        void assert_gt(Arg1 val, Arg2 val2, const std::source_location location = std::source_location::current()) {
-            this->assert(Gt, val, val2, location);
+    template <typename T>
+    class task_promise : public task_promise_base {
+    public:
+        std::optional<T> value;
+    public:
+        template <typename Val>
+        void return_value(Val&& val) {
+            this->value.emplace(std::forward<Val>(val));
         }
 
-        template <typename Arg1, typename Arg2>
-        void assert_lt(Arg1 val, Arg2 val2, const std::source_location location = std::source_location::current()) {
-            this->assert(Lt, val, val2, location);
-        }
+        T take() {
+            if(this->error)
+                std::rethrow_exception(this->error);
 
-        template <typename Arg1, typename Arg2>
-        void assert_geq(Arg1 val, Arg2 val2, const std::source_location location = std::source_location::current()) {
-            this->assert(GEq, val, val2, location);
+            return std::move(*this->value);
         }
+    };
 
-        template <typename Arg1, typename Arg2>
-        void assert_leq(Arg1 val, Arg2 val2, const std::source_location location = std::source_location::current()) {
-            this->assert(LEq, val, val2, location);
+    template <>
+    class task_promise<void> : public task_promise_base {
+    public:
+        void return_void() const noexcept {}
+
+        void take() const {
+            if(this->error)
+                std::rethrow_exception(this->error);
         }
     };
-}
 
-#define TEST(case_name) \
-    void case_name();  \
-    gech::test test_reg(case_name);\
-    void case_name()
+    // what CO_TEST() bodies and the coroutines they await return.
+    template <typename T = void>
+    class task {
+    public:
+        class promise_type : public task_promise<T> {
+        public:
+            task get_return_object() noexcept {
+                return task(std::coroutine_handle<promise_type>::from_promise(*this));
+            }
+        };
 
+        std::coroutine_handle<promise_type> handle;
+    public:
+        explicit task(std::coroutine_handle<promise_type> handle) noexcept : handle(handle) {}
+        task(task&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+        task(const task&) = delete;
+        task& operator=(const task&) = delete;
 
-#define TEST_MAIN \
-    int main(int argc, char** argv) { \
-        test_reg.run_tests(); \
-    }
+        ~task() {
+            this->reset();
+        }
 
-#define TEST_DATA test_reg
+        void reset() noexcept {
+            if(this->handle)
+                this->handle.destroy();
 
-#define ALLOC(name, type) \
-    test_reg.assert_rc(); \
-    ++test_reg.rc;        \
-    type* name = new type;
+            this->handle = nullptr;
+        }
 
-#define DEALLOC(name) \
-    --test_reg.rc;    \
-    test_reg.assert_rc(); \
-    delete name;
+        bool await_ready() const noexcept {
+            return !this->handle || this->handle.done();
+        }
 
-#define ASSERT_EQ(val, val2) \
-    test_reg.assert_eq(val, val2);
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+            this->handle.promise().continuation = caller;
+            return this->handle;
+        }
 
-#define ASSERT_UNEQ(val, val2) \
-    test_reg.assert_uneq(val, val2);
+        T await_resume() {
+            return this->handle.promise().take();
+        }
+    };
 
-#define ASSERT_GT(val, val2) \
-    test_reg.assert_gt(val, val2);
+    using co_test = task<>(*)();
 
-#define ASSERT_LT(val, val2) \
-    test_reg.assert_lt(val, val2);
+    class test_case {
+    public:
+        string name;
+        function_test func;
 
-#define ASSERT_GEQ(val, val2) \
-    test_reg.assert_geq(val, val2);
+        std::source_location location;
+
+        // CO_TEST() bodies, which a serial run interleaves on one event loop.
+        co_test co_func = nullptr;
+        std::uint64_t timeout_ms = 0;
+    public:
+        test_case(string name, function_test func, std::source_location location,
+                  co_test co_func = nullptr, std::uint64_t timeout_ms = 0)
+            : name(name), func(func), location(location), co_func(co_func), timeout_ms(timeout_ms) {}
+        ~test_case() = default;
+    };
+
+    // every TEST() appends itself here during static initialization,
+    // TEST_MAIN walks it in registration order.
+    inline std::vector<test_case>& registry() {
+        static std::vector<test_case> cases;
+        return cases;
+    }
+
+    class test_register {
+    public:
+        test_register(string name, function_test func,
+                      const std::source_location location = std::source_location::current()) {
+            gech::registry().emplace_back(name, func, location);
+        }
+
+        // func drives body alone, for runners that take one case at a time.
+        test_register(string name, function_test func, co_test body, std::uint64_t timeout_ms,
+                      const std::source_location location = std::source_location::current()) {
+            gech::registry().emplace_back(name, func, location, body, timeout_ms);
+        }
+    };
+
+    // names of generated cases, the registry only keeps views.
+    inline string keep_name(std::string name) {
+        static std::deque<std::string> names;
+        names.push_back(std::move(name));
+        return names.back();
+    }
+
+    // the compiler's spelling of T, read out of the function signature.
+    template <typename T>
+    constexpr std::string_view type_name() noexcept {
+        #if defined(_MSC_VER) && !defined(__clang__)
+            constexpr std::string_view signature = __FUNCSIG__;
+            constexpr auto begin = signature.find("type_name<") + 10;
+            constexpr auto end = signature.rfind(">(void)");
+        #else
+            constexpr std::string_view signature = __PRETTY_FUNCTION__;
+            constexpr auto begin = signature.find("T = ") + 4;
+            constexpr auto end = signature.find(';', begin) != std::string_view::npos
+                                 ? signature.find(';', begin)
+                                 : signature.rfind(']');
+        #endif
+
+        return signature.substr(begin, end - begin);
+    }
+
+    // timings and baselines split on whitespace, so a case name has none:
+    // "unsigned int" becomes unsigned_int, "std::pair<int, int>" std::pair<int,int>.
+    inline std::string typed_name(const string name, const std::string_view type) {
+        std::string text(name);
+        text += '<';
+
+        const auto word = [](const char c) {
+            return std::isalnum(static_cast<unsigned char>(c)) || c == '_';
+        };
+
+        for(std::size_t i = 0; i < type.size(); ++i) {
+            if(type[i] != ' ')
+                text += type[i];
+            else if(i != 0 && i + 1 < type.size() && word(type[i - 1]) && word(type[i + 1]))
+                text += '_';
+        }
+
+        text += '>';
+        return text;
+    }
+
+    // TYPED_TEST(): one case per type, each its own instantiation of the body.
+    template <typename... Types>
+    class typed_register {
+    public:
+        template <typename Make>
+        typed_register(string name, Make make,
+                       const std::source_location location = std::source_location::current()) {
+            (gech::registry().emplace_back(gech::keep_name(gech::typed_name(name, gech::type_name<Types>())),
+                                           make(std::type_identity<Types>()), location), ...);
+        }
+    };
+
+    // TEST_P(): one case per value, "name/index", the index a template argument.
+    template <std::size_t Count>
+    class param_register {
+    public:
+        template <typename Make>
+        param_register(string name, Make make,
+                       const std::source_location location = std::source_location::current()) {
+            [&]<std::size_t... Index>(std::index_sequence<Index...>) {
+                (gech::registry().emplace_back(gech::keep_name(std::string(name) + '/' + std::to_string(Index)),
+                                               make(std::integral_constant<std::size_t, Index>()), location), ...);
+            }(std::make_index_sequence<Count>());
+        }
+    };
+
+    // how long BENCH() keeps sampling, --bench-max-ms and --bench-samples.
+    class bench_config {
+    public:
+        std::uint64_t warmup = 10;
+        std::uint64_t min_samples = 30, max_samples = 1000;
+
+        // a benchmark stops at this much wall time even if it never settled.
+        std::uint64_t max_ns = 1'000'000'000;
+
+        // relative standard error of the mean that counts as stable.
+        double stable_error = 0.01;
+    public:
+        bench_config() = default; ~bench_config() = default;
+    };
+
+    // FUZZ_TEST() replays its corpus unless --fuzz (GECHTEST_FUZZ) is given,
+    // then it mutates inputs for --fuzz-ms or --fuzz-runs, whichever ends
+    // first. the corpus lives in --corpus (GECHTEST_CORPUS)/<case name>.
+    class fuzz_config {
+    public:
+        bool enabled = false;
+
+        // 0 means no limit.
+        std::uint64_t runs = 0;
+        std::uint64_t max_ns = 10'000'000'000;
+
+        std::size_t max_len = 4096;
+
+        std::string corpus;
+    public:
+        fuzz_config() = default; ~fuzz_config() = default;
+    };
+
+    class options {
+    public:
+        // 0 means one job per hardware thread.
+        unsigned jobs = 1;
+
+        // run cases in forked worker processes, so a crash costs one case.
+        bool isolate = false;
+
+        // count passing assertions without logging them, --quiet or GECHTEST_QUIET.
+        bool quiet = false;
+
+        // log nodes kept in memory per context before spilling to disk,
+        // --arena-cap or GECHTEST_ARENA_CAP, 0 means unbounded.
+        std::size_t arena_cap = 1 << 16;
+
+        // this process runs shard_index of total_shards, from
+        // GECHTEST_SHARD_INDEX / GECHTEST_TOTAL_SHARDS.
+        unsigned shard_index = 0, total_shards = 1;
+
+        // --shards N re-runs the binary as N local shard processes.
+        unsigned shards = 0;
+
+        // per-case timings from earlier runs, --timings or GECHTEST_TIMINGS.
+        std::string timings;
+
+        // compare against / write a timing baseline, --baseline and --baseline-write
+        // (GECHTEST_BASELINE, GECHTEST_BASELINE_WRITE). each case then runs
+        // baseline_samples times, and slower than baseline_threshold percent fails.
+        std::string baseline, baseline_write;
+        double baseline_threshold = 10;
+        unsigned baseline_samples = 5;
+
+        gech::bench_config bench;
+
+        // hardware counters per case and per benchmark, --perf or GECHTEST_PERF.
+        bool perf = false;
+
+        // "NAME" or "NAME:PATH" per --reporter (GECHTEST_REPORTER), NAME is
+        // console, junit or jsonl and output goes to stdout without a PATH.
+        // only console without one when empty.
+        std::vector<std::string> reporters;
+
+        // PROPERTY() runs per property and the seed they draw from, --property-runs
+        // and --seed (GECHTEST_PROPERTY_RUNS, GECHTEST_SEED); parse() picks a
+        // random seed unless one is given.
+        unsigned property_runs = 1000;
+        std::uint64_t seed = 0;
+
+        gech::fuzz_config fuzz;
+
+        // a CO_TEST() running longer fails, --co-timeout or GECHTEST_CO_TIMEOUT;
+        // 0 means no limit. CO_TEST_TIMEOUT() sets its own.
+        std::uint64_t co_timeout_ms = 10000;
+
+        char** argv = nullptr;
+    public:
+        options() = default; ~options() = default;
+
+        static options parse(int argc, char** argv) {
+            gech::options opts;
+            opts.argv = argv;
+
+            std::random_device device;
+            opts.seed = static_cast<std::uint64_t>(device()) << 32 | device();
+
+            if(const auto total = std::getenv("GECHTEST_TOTAL_SHARDS"))
+                opts.total_shards = std::strtoul(total, nullptr, 10);
+
+            if(const auto index = std::getenv("GECHTEST_SHARD_INDEX"))
+                opts.shard_index = std::strtoul(index, nullptr, 10);
+
+            if(const auto timings = std::getenv("GECHTEST_TIMINGS"))
+                opts.timings = timings;
+
+            if(const auto quiet = std::getenv("GECHTEST_QUIET"))
+                opts.quiet = *quiet != '\0' && *quiet != '0';
+
+            if(const auto baseline = std::getenv("GECHTEST_BASELINE"))
+                opts.baseline = baseline;
+
+            if(const auto baseline = std::getenv("GECHTEST_BASELINE_WRITE"))
+                opts.baseline_write = baseline;
+
+            if(const auto perf = std::getenv("GECHTEST_PERF"))
+                opts.perf = *perf != '\0' && *perf != '0';
+
+            if(const auto cap = std::getenv("GECHTEST_ARENA_CAP"))
+                opts.arena_cap = std::strtoull(cap, nullptr, 10);
+
+            if(const auto reporter = std::getenv("GECHTEST_REPORTER"))
+                opts.reporters.push_back(reporter);
+
+            if(const auto runs = std::getenv("GECHTEST_PROPERTY_RUNS"))
+                opts.property_runs = std::strtoul(runs, nullptr, 10);
+
+            if(const auto seed = std::getenv("GECHTEST_SEED"))
+                opts.seed = std::strtoull(seed, nullptr, 10);
+
+            if(const auto fuzz = std::getenv("GECHTEST_FUZZ"))
+                opts.fuzz.enabled = *fuzz != '\0' && *fuzz != '0';
+
+            if(const auto corpus = std::getenv("GECHTEST_CORPUS"))
+                opts.fuzz.corpus = corpus;
+
+            if(const auto timeout = std::getenv("GECHTEST_CO_TIMEOUT"))
+                opts.co_timeout_ms = std::strtoull(timeout, nullptr, 10);
+
+            for(int i = 1; i < argc; ++i) {
+                const string arg = argv[i];
+
+                if((arg == "--jobs" || arg == "-j") && i + 1 < argc)
+                    opts.jobs = std::strtoul(argv[++i], nullptr, 10);
+                else if(arg.starts_with("--jobs="))
+                    opts.jobs = std::strtoul(argv[i] + 7, nullptr, 10);
+                else if(arg == "--isolate")
+                    opts.isolate = true;
+                else if(arg == "--quiet" || arg == "-q")
+                    opts.quiet = true;
+                else if(arg == "--arena-cap" && i + 1 < argc)
+                    opts.arena_cap = std::strtoull(argv[++i], nullptr, 10);
+                else if(arg == "--perf")
+                    opts.perf = true;
+                else if(arg == "--baseline" && i + 1 < argc)
+                    opts.baseline = argv[++i];
+                else if(arg == "--baseline-write" && i + 1 < argc)
+                    opts.baseline_write = argv[++i];
+                else if(arg == "--baseline-threshold" && i + 1 < argc)
+                    opts.baseline_threshold = std::strtod(argv[++i], nullptr);
+                else if(arg == "--baseline-samples" && i + 1 < argc)
+                    opts.baseline_samples = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+                else if(arg == "--bench-max-ms" && i + 1 < argc)
+                    opts.bench.max_ns = std::strtoull(argv[++i], nullptr, 10) * 1'000'000;
+                else if(arg == "--bench-samples" && i + 1 < argc)
+                    opts.bench.max_samples = std::max<std::uint64_t>(std::strtoull(argv[++i], nullptr, 10), 2);
+                else if(arg == "--shards" && i + 1 < argc)
+                    opts.shards = std::strtoul(argv[++i], nullptr, 10);
+                else if(arg == "--timings" && i + 1 < argc)
+                    opts.timings = argv[++i];
+                else if(arg.starts_with("--timings="))
+                    opts.timings = argv[i] + 10;
+                else if(arg == "--reporter" && i + 1 < argc)
+                    opts.reporters.push_back(argv[++i]);
+                else if(arg.starts_with("--reporter="))
+                    opts.reporters.push_back(argv[i] + 11);
+                else if(arg == "--property-runs" && i + 1 < argc)
+                    opts.property_runs = std::strtoul(argv[++i], nullptr, 10);
+                else if(arg == "--seed" && i + 1 < argc)
+                    opts.seed = std::strtoull(argv[++i], nullptr, 10);
+                else if(arg == "--fuzz")
+                    opts.fuzz.enabled = true;
+                else if(arg == "--fuzz-runs" && i + 1 < argc)
+                    opts.fuzz.runs = std::strtoull(argv[++i], nullptr, 10);
+                else if(arg == "--fuzz-ms" && i + 1 < argc)
+                    opts.fuzz.max_ns = std::strtoull(argv[++i], nullptr, 10) * 1'000'000;
+                else if(arg == "--fuzz-max-len" && i + 1 < argc)
+                    opts.fuzz.max_len = std::max(1ul, std::strtoul(argv[++i], nullptr, 10));
+                else if(arg == "--corpus" && i + 1 < argc)
+                    opts.fuzz.corpus = argv[++i];
+                else if(arg == "--co-timeout" && i + 1 < argc)
+                    opts.co_timeout_ms = std::strtoull(argv[++i], nullptr, 10);
+            }
+
+            for(const auto& reporter : opts.reporters) {
+                const string name = string(reporter).substr(0, reporter.find(':'));
+
+                if((name != "console" && name != "junit" && name != "jsonl")
+                || (name == "console" && name.size() != reporter.size())) {
+                    std::cerr << "gechtest: unknown reporter " << reporter
+                              << ", expected console, junit[:PATH] or jsonl[:PATH]\n";
+                    std::exit(2);
+                }
+            }
+
+            if(opts.jobs == 0)
+                opts.jobs = std::max(1u, std::thread::hardware_concurrency());
+
+            if(opts.total_shards == 0 || opts.shard_index >= opts.total_shards) {
+                std::cerr << "gechtest: GECHTEST_SHARD_INDEX must be below GECHTEST_TOTAL_SHARDS\n";
+                std::exit(2);
+            }
+
+            return opts;
+        }
+    };
+
+    // per-iteration statistics of one BENCH(), in nanoseconds.
+    class bench_result {
+    public:
+        string name;
+        std::uint64_t iterations = 0, samples = 0;
+        std::uint64_t min = 0, median = 0, p99 = 0, mean = 0, stddev = 0;
+
+        // per iteration, with --perf.
+        perf_sample counters;
+
+        // max_ns ran out before min_samples were taken.
+        bool exhausted = false;
+
+        std::source_location location;
+    public:
+        bench_result() = default; ~bench_result() = default;
+    };
+
+    // keeps value (and whatever computed it) alive without emitting any code.
+    template <typename Val>
+    inline void do_not_optimize(const Val& value) noexcept {
+        #if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : "r,m"(value) : "memory");
+        #else
+            static const volatile void* sink;
+            sink = &value;
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        #endif
+    }
+
+    // forces pending stores to memory as far as the compiler is concerned.
+    inline void clobber_memory() noexcept {
+        #if defined(__GNUC__) || defined(__clang__)
+            asm volatile("" : : : "memory");
+        #else
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        #endif
+    }
+
+    // running mean and variance (Welford), what the baseline keeps per case.
+    class sample_stats {
+    public:
+        std::uint64_t count = 0;
+        double mean = 0, m2 = 0;
+    public:
+        sample_stats() = default; ~sample_stats() = default;
+
+        void add(const double value) noexcept {
+            ++this->count;
+
+            const double delta = value - this->mean;
+            this->mean += delta / this->count;
+            this->m2 += delta * (value - this->mean);
+        }
+
+        double variance() const noexcept {
+            return this->count > 1 ? this->m2 / (this->count - 1) : 0;
+        }
+    };
+
+    class baseline_entry {
+    public:
+        string name;
+        sample_stats stats;
+    public:
+        baseline_entry() = default; ~baseline_entry() = default;
+    };
+
+    // per-case timing samples of an earlier run, one "name count mean stddev"
+    // line per case. a case regresses when it is more than threshold percent
+    // slower on average and Welch's t-test says the slowdown is not noise.
+    class baseline {
+    public:
+        std::map<std::string, sample_stats, std::less<>> cases;
+    public:
+        baseline() = default; ~baseline() = default;
+
+        void load(const std::string& path) {
+            std::ifstream file(path);
+            std::string name;
+            sample_stats stats;
+            double stddev;
+
+            while(file >> name >> stats.count >> stats.mean >> stddev) {
+                stats.m2 = stats.count > 1 ? stddev * stddev * (stats.count - 1) : 0;
+                this->cases[name] = stats;
+            }
+        }
+
+        void save(const std::string& path) const {
+            std::ofstream file(path, std::ios::trunc);
+
+            for(const auto& [name, stats] : this->cases)
+                file << name << ' ' << stats.count << ' ' << stats.mean << ' ' << std::sqrt(stats.variance()) << '\n';
+        }
+
+        void record(const baseline_entry& entry) {
+            this->cases[std::string(entry.name)] = entry.stats;
+        }
+
+        // one-sided 95% critical value of Student's t, Cornish-Fisher around z.
+        static double critical_t(const double df) noexcept {
+            constexpr double z = 1.6448536269514722;
+            const double z3 = z * z * z, z5 = z3 * z * z;
+
+            return z + (z3 + z) / (4 * df) + (5 * z5 + 16 * z3 + 3 * z) / (96 * df * df);
+        }
+
+        static bool regressed(const sample_stats& before, const sample_stats& now, const double threshold) noexcept {
+            if(now.mean <= before.mean * (1 + threshold / 100))
+                return false;
+
+            // a single sample on either side cannot tell noise from a slowdown.
+            if(before.count < 2 || now.count < 2)
+                return false;
+
+            const double before_error = before.variance() / before.count;
+            const double now_error = now.variance() / now.count;
+            const double error = before_error + now_error;
+
+            if(error == 0)
+                return true;
+
+            const double t = (now.mean - before.mean) / std::sqrt(error);
+            const double df = error * error / (before_error * before_error / (before.count - 1)
+                                             + now_error * now_error / (now.count - 1));
+
+            return t > critical_t(std::max(df, 1.0));
+        }
+    };
+
+    class perf_result {
+    public:
+        string name;
+        perf_sample counters;
+    public:
+        perf_result() = default; ~perf_result() = default;
+    };
+
+    // everything a worker collected while running one case,
+    // merged back into test_reg in registration order.
+    class case_result {
+    public:
+        unsigned errors = 0, passes = 0;
+        std::uint64_t ms_took = 0;
+        int rc = 0;
+
+        std::vector<bench_result> benches;
+        std::vector<perf_result> perf;
+        std::vector<baseline_entry> baseline;
+
+        std::source_location current_location;
+    public:
+        case_result() = default; ~case_result() = default;
+    };
+
+    // nanoseconds each case took in earlier runs, one "name ns" pair per line.
+    // shards assign cases from it greedily, most expensive first, to the least
+    // loaded shard; every shard computes the same split from the same file.
+    class timings {
+    public:
+        std::map<std::string, unsigned long long, std::less<>> cost;
+    public:
+        timings() = default; ~timings() = default;
+
+        void load(const std::string& path) {
+            std::ifstream file(path);
+            std::string name;
+            unsigned long long ns;
+
+            while(file >> name >> ns)
+                this->cost[name] = ns;
+        }
+
+        void save(const std::string& path) const {
+            std::ofstream file(path, std::ios::trunc);
+
+            for(const auto& [name, ns] : this->cost)
+                file << name << ' ' << ns << '\n';
+        }
+
+        void record(const string name, unsigned long long ns) {
+            if(ns != 0)
+                this->cost[std::string(name)] = ns;
+        }
+
+        std::vector<std::size_t> shard(const std::vector<test_case>& cases, unsigned index, unsigned total) const {
+            std::vector<std::size_t> selected;
+            std::vector<unsigned long long> costs(cases.size());
+            unsigned long long known = 0, sum = 0;
+
+            if(total <= 1) {
+                for(std::size_t i = 0; i < cases.size(); ++i)
+                    selected.push_back(i);
+
+                return selected;
+            }
+
+            for(std::size_t i = 0; i < cases.size(); ++i) {
+                if(const auto found = this->cost.find(cases[i].name); found != this->cost.end()) {
+                    costs[i] = found->second;
+                    sum += found->second;
+                    ++known;
+                }
+            }
+
+            // cases without history cost as much as an average known one.
+            const unsigned long long fallback = known != 0 ? std::max(sum / known, 1ull) : 1;
+            std::vector<std::size_t> order(cases.size());
+
+            for(std::size_t i = 0; i < cases.size(); ++i) {
+                order[i] = i;
+
+                if(costs[i] == 0)
+                    costs[i] = fallback;
+            }
+
+            std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) {
+                if(costs[a] != costs[b])
+                    return costs[a] > costs[b];
+
+                return cases[a].name < cases[b].name;
+            });
+
+            std::vector<unsigned long long> loads(total);
+
+            for(const auto i : order) {
+                const auto lightest = std::min_element(loads.begin(), loads.end()) - loads.begin();
+                loads[lightest] += costs[i];
+
+                if(lightest == index)
+                    selected.push_back(i);
+            }
+
+            std::sort(selected.begin(), selected.end());
+            return selected;
+        }
+    };
+
+    // per-worker deque of registry indices; the owner pops from the front,
+    // idle workers steal from the back.
+    class work_queue {
+    public:
+        std::deque<std::size_t> cases;
+        std::mutex lock;
+    public:
+        work_queue() = default; ~work_queue() = default;
+
+        bool pop(std::size_t& index) {
+            std::lock_guard<std::mutex> guard(this->lock);
+
+            if(this->cases.empty())
+                return false;
+
+            index = this->cases.front();
+            this->cases.pop_front();
+            return true;
+        }
+
+        bool steal(std::size_t& index) {
+            std::lock_guard<std::mutex> guard(this->lock);
+
+            if(this->cases.empty())
+                return false;
+
+            index = this->cases.back();
+            this->cases.pop_back();
+            return true;
+        }
+    };
+
+    inline const char* result_label(const test_results result) noexcept {
+        switch(result) {
+            case Critical: return "[CRITICAL]: ";
+            case Success: return "[SUCCESS]: ";
+            default: return "[FAILED]: ";
+        }
+    }
+
+    enum record_kinds : std::uint8_t {
+        Assertion,
+        CaseEnd
+    };
+
+    // fixed-size unit of output; put() only fills one of these in, the
+    // text is produced later on the writer thread.
+    class record {
+    public:
+        static constexpr std::uint32_t npos = ~std::uint32_t(0);
+
+        record_kinds kind = Assertion;
+        test_results result = Success;
+
+        // data lives in writer().keep() instead of static storage.
+        bool kept = false;
+
+        // position of the owning case in this run, npos writes straight through.
+        std::uint32_t case_index = npos;
+        std::uint64_t ms_took = 0;
+        string data;
+
+        std::source_location location;
+
+        // the case's registered name, for records located where it was
+        // registered: that location's function is a static initializer.
+        string function;
+    public:
+        record() = default; ~record() = default;
+
+        string function_name() const noexcept {
+            return this->function.empty() ? string(this->location.function_name()) : this->function;
+        }
+    };
+
+    inline void append_json(std::string& text, const string data) {
+        static constexpr char hex[] = "0123456789abcdef";
+
+        for(const char c : data) {
+            switch(c) {
+                case '"': text += "\\\""; break;
+                case '\\': text += "\\\\"; break;
+                case '\n': text += "\\n"; break;
+                case '\t': text += "\\t"; break;
+                default:
+                    if(static_cast<unsigned char>(c) < 0x20) {
+                        text += "\\u00";
+                        text += hex[c >> 4];
+                        text += hex[c & 0xf];
+                    } else
+                        text += c;
+            }
+        }
+    }
+
+    inline void append_xml(std::string& text, const string data) {
+        for(const char c : data) {
+            switch(c) {
+                case '"': text += "&quot;"; break;
+                case '&': text += "&amp;"; break;
+                case '<': text += "&lt;"; break;
+                case '>': text += "&gt;"; break;
+                default:
+                    if(static_cast<unsigned char>(c) >= 0x20 || c == '\n' || c == '\t')
+                        text += c;
+            }
+        }
+    }
+
+    // turns records into text on the writer thread. everything goes into
+    // the text of the record's case, which the writer holds back until every
+    // earlier case has ended, so reporters see cases in registration order.
+    class reporter {
+    public:
+        reporter() = default; virtual ~reporter() = default;
+
+        virtual void begin(std::string&) {}
+        virtual void assertion(std::string& text, const record& entry) = 0;
+
+        // entry.data is the case name, entry.ms_took its run time.
+        virtual void case_end(std::string&, const record&) {}
+        virtual void end(std::string&, unsigned /* errors */, unsigned /* passes */, std::uint64_t /* ns */) {}
+    };
+
+    // the human readable log, the summary itself is printed by gech::test.
+    class console_reporter : public reporter {
+    public:
+        console_reporter() = default; ~console_reporter() = default;
+
+        void assertion(std::string& text, const record& entry) override {
+            text += gech::result_label(entry.result);
+            text += "(";
+            text += entry.location.file_name();
+            text += ", ";
+            gech::append_number(text, entry.location.line());
+            text += ":";
+            gech::append_number(text, entry.location.column());
+            text += ":";
+            gech::append_number(text, entry.ms_took);
+            text += "ns) [";
+            text += entry.function_name();
+            text += "] -> ";
+            text += entry.data;
+            text += '\n';
+        }
+    };
+
+    // one <testcase> per case, written when the case ends. passes leave no
+    // trace in the xml, so only failures of still running cases are held.
+    // test and failure counts are not known up front and left out of <testsuite>.
+    class junit_reporter : public reporter {
+    public:
+        std::map<std::uint32_t, std::string> failures;
+    public:
+        junit_reporter() = default; ~junit_reporter() = default;
+
+        void begin(std::string& text) override {
+            text += "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n<testsuites>\n<testsuite name=\"gechtest\">\n";
+        }
+
+        void assertion(std::string& text, const record& entry) override {
+            if(entry.result == Success)
+                return;
+
+            std::string failure = "    <failure type=\"";
+            failure += entry.result == Critical ? "critical" : "error";
+            failure += "\" message=\"";
+            gech::append_xml(failure, entry.data);
+            failure += "\">";
+            gech::append_xml(failure, entry.location.file_name());
+            failure += ':';
+            gech::append_number(failure, entry.location.line());
+            failure += ':';
+            gech::append_number(failure, entry.location.column());
+            failure += " in ";
+            gech::append_xml(failure, entry.function_name());
+            failure += "</failure>\n";
+
+            // outside of any case (rc checks after the run), a testcase of its own.
+            if(entry.case_index == record::npos) {
+                text += "  <testcase classname=\"gechtest\" name=\"suite\">\n";
+                text += failure;
+                text += "  </testcase>\n";
+                return;
+            }
+
+            this->failures[entry.case_index] += failure;
+        }
+
+        void case_end(std::string& text, const record& entry) override {
+            text += "  <testcase classname=\"";
+            gech::append_xml(text, entry.location.file_name());
+            text += "\" name=\"";
+            gech::append_xml(text, entry.data);
+            text += "\" time=\"";
+            gech::append_number(text, entry.ms_took / 1e9, 6);
+            text += '"';
+
+            const auto found = this->failures.find(entry.case_index);
+
+            if(found == this->failures.end()) {
+                text += "/>\n";
+                return;
+            }
+
+            text += ">\n";
+            text += found->second;
+            text += "  </testcase>\n";
+            this->failures.erase(found);
+        }
+
+        void end(std::string& text, unsigned, unsigned, std::uint64_t) override {
+            text += "</testsuite>\n</testsuites>\n";
+        }
+    };
+
+    // one json object per line: every assertion, every case end, then a summary.
+    class jsonl_reporter : public reporter {
+    public:
+        jsonl_reporter() = default; ~jsonl_reporter() = default;
+
+        void assertion(std::string& text, const record& entry) override {
+            text += "{\"type\":\"assertion\",\"case\":";
+            if(entry.case_index == record::npos)
+                text += "null";
+            else
+                gech::append_number(text, entry.case_index);
+
+            text += ",\"result\":\"";
+            text += entry.result == Success ? "success" : entry.result == Critical ? "critical" : "error";
+            text += "\",\"file\":\"";
+            gech::append_json(text, entry.location.file_name());
+            text += "\",\"line\":";
+            gech::append_number(text, entry.location.line());
+            text += ",\"column\":";
+            gech::append_number(text, entry.location.column());
+            text += ",\"function\":\"";
+            gech::append_json(text, entry.function_name());
+            text += "\",\"ns\":";
+            gech::append_number(text, entry.ms_took);
+            text += ",\"message\":\"";
+            gech::append_json(text, entry.data);
+            text += "\"}\n";
+        }
+
+        void case_end(std::string& text, const record& entry) override {
+            text += "{\"type\":\"case\",\"case\":";
+            gech::append_number(text, entry.case_index);
+            text += ",\"name\":\"";
+            gech::append_json(text, entry.data);
+            text += "\",\"file\":\"";
+            gech::append_json(text, entry.location.file_name());
+            text += "\",\"ns\":";
+            gech::append_number(text, entry.ms_took);
+            text += "}\n";
+        }
+
+        void end(std::string& text, unsigned errors, unsigned passes, std::uint64_t ns) override {
+            text += "{\"type\":\"summary\",\"errors\":";
+            gech::append_number(text, errors);
+            text += ",\"passes\":";
+            gech::append_number(text, passes);
+            text += ",\"ns\":";
+            gech::append_number(text, ns);
+            text += "}\n";
+        }
+    };
+
+    // "console", "junit" or "jsonl", nullptr for anything else.
+    inline std::unique_ptr<reporter> make_reporter(const string name) {
+        if(name == "console")
+            return std::make_unique<console_reporter>();
+
+        if(name == "junit")
+            return std::make_unique<junit_reporter>();
+
+        if(name == "jsonl")
+            return std::make_unique<jsonl_reporter>();
+
+        return nullptr;
+    }
+
+    // somewhere formatted text ends up.
+    class output {
+    public:
+        output() = default; virtual ~output() = default;
+
+        virtual void write(const char* data, std::size_t size) = 0;
+    };
+
+    class file_output : public output {
+    public:
+        std::FILE* file;
+    public:
+        file_output(std::FILE* file) : file(file) {}
+
+        ~file_output() {
+            if(this->file != stdout)
+                std::fclose(this->file);
+        }
+
+        void write(const char* data, std::size_t size) override {
+            #ifdef GECHTEST_HAS_POSIX
+                while(size > 0) {
+                    const auto written = ::write(::fileno(this->file), data, size);
+
+                    if(written < 0 && errno == EINTR)
+                        continue;
+
+                    if(written <= 0)
+                        break;
+
+                    data += written;
+                    size -= written;
+                }
+            #else
+                std::fwrite(data, 1, size, this->file);
+                std::fflush(this->file);
+            #endif
+        }
+    };
+
+    // the console log kept in memory for TEST_GET_AS_STRING, appended to by
+    // the writer thread while tests may be reading it.
+    class string_output : public output {
+    public:
+        mutable std::mutex lock;
+        std::string text;
+    public:
+        string_output() = default; ~string_output() = default;
+
+        void write(const char* data, std::size_t size) override {
+            std::lock_guard<std::mutex> guard(this->lock);
+            this->text.append(data, size);
+        }
+
+        std::string str() const {
+            std::lock_guard<std::mutex> guard(this->lock);
+            return this->text;
+        }
+    };
+
+    // a reporter with the text of cases that cannot be written yet because an
+    // earlier one is still running. the text is formatted once into batch,
+    // then handed to every output as is.
+    class report_sink {
+    public:
+        std::unique_ptr<reporter> format;
+
+        std::unique_ptr<output> file;
+        std::vector<output*> outputs;
+
+        std::string batch;
+        std::vector<std::string> pending;
+    public:
+        report_sink() = default; ~report_sink() = default;
+
+        // writes to file (stdout, or one opened for this sink) and to the rest of outputs.
+        void open(std::FILE* file) {
+            this->file = std::make_unique<file_output>(file);
+            this->outputs.push_back(this->file.get());
+        }
+
+        std::string& text(const std::uint32_t case_index, const std::uint32_t next_case) {
+            return case_index == next_case || case_index >= this->pending.size()
+                   ? this->batch : this->pending[case_index];
+        }
+    };
+
+    // single-producer single-consumer ring, one per asserting thread.
+    class record_ring {
+    public:
+        static constexpr std::size_t capacity = 4096;
+
+        std::array<record, capacity> records;
+
+        alignas(64) std::atomic<std::size_t> head { 0 };
+        alignas(64) std::atomic<std::size_t> tail { 0 };
+
+        std::atomic<bool> in_use { true };
+    public:
+        record_ring() = default; ~record_ring() = default;
+
+        bool push(const record& entry) noexcept {
+            const auto at = this->tail.load(std::memory_order_relaxed);
+
+            if(at - this->head.load(std::memory_order_acquire) == capacity)
+                return false;
+
+            this->records[at % capacity] = entry;
+            this->tail.store(at + 1, std::memory_order_release);
+            return true;
+        }
+
+        std::size_t size() const noexcept {
+            return this->tail.load(std::memory_order_acquire) - this->head.load(std::memory_order_acquire);
+        }
+
+        template <typename Func>
+        void drain(Func&& func) {
+            auto at = this->head.load(std::memory_order_relaxed);
+            const auto end = this->tail.load(std::memory_order_acquire);
+
+            for(; at != end; ++at)
+                func(this->records[at % capacity]);
+
+            this->head.store(at, std::memory_order_release);
+        }
+    };
+
+    // owns every record_ring and the background thread that feeds records to
+    // the reporters. cases finishing out of order (--jobs) are held back until
+    // every earlier case has been written, so output stays in registration order.
+    class log_writer {
+    public:
+        std::vector<std::unique_ptr<record_ring>> rings;
+        std::mutex rings_lock;
+
+        std::mutex lock;
+        std::condition_variable wake, done;
+        unsigned long long requested = 0, completed = 0;
+        bool stop = false;
+
+        // everything below is only touched by the writer thread, or under state_lock.
+        std::mutex state_lock;
+        std::vector<record_ring*> snapshot;
+        std::vector<std::unique_ptr<report_sink>> sinks;
+        std::vector<bool> ended;
+        std::uint32_t next_case = 0;
+
+        // the console log as a string, TEST_GET_AS_STRING only.
+        std::unique_ptr<string_output> captured;
+
+        // text records point at that is not a literal: failure details,
+        // crash reports. it stays until the record is consumed, see release().
+        std::mutex kept_lock;
+        std::unordered_map<const char*, std::unique_ptr<std::string>> kept;
+
+        #ifdef GECHTEST_HAS_FORK
+            // an isolated worker inherits this object, but not the thread.
+            const pid_t owner = ::getpid();
+        #endif
+
+        // set by the first salvage(), nothing is written after it.
+        std::atomic<bool> salvaged = false;
+
+        std::thread thread;
+    public:
+        log_writer() : thread([this] { this->run(); }) {
+            std::lock_guard<std::mutex> guard(this->state_lock);
+
+            #ifdef TEST_GET_AS_STRING
+                this->captured = std::make_unique<string_output>();
+            #endif
+
+            this->sinks.push_back(std::make_unique<report_sink>());
+            this->sinks.back()->format = std::make_unique<console_reporter>();
+            this->sinks.back()->open(stdout);
+            this->attach_capture();
+        }
+
+        ~log_writer() {
+            this->join_thread();
+        }
+
+        // stops the writer thread for good, flush() and a full ring then
+        // write on the calling thread. --isolate does so before it forks, so
+        // no worker inherits a lock the thread was holding.
+        void join_thread() {
+            if(!this->thread.joinable())
+                return;
+
+            {
+                std::lock_guard<std::mutex> guard(this->lock);
+                this->stop = true;
+            }
+
+            this->wake.notify_one();
+            this->thread.join();
+        }
+
+        // resets ordering for a run of case_count cases.
+        void begin(std::uint32_t case_count) {
+            this->flush();
+
+            std::lock_guard<std::mutex> guard(this->state_lock);
+
+            for(auto& sink : this->sinks)
+                sink->pending.assign(case_count, {});
+
+            this->ended.assign(case_count, false);
+            this->next_case = 0;
+        }
+
+        // replaces the reporters, each one starts its document right away.
+        void use(std::vector<std::unique_ptr<report_sink>> sinks) {
+            this->flush();
+
+            std::lock_guard<std::mutex> guard(this->state_lock);
+            this->sinks = std::move(sinks);
+
+            for(auto& sink : this->sinks)
+                sink->format->begin(sink->batch);
+
+            this->attach_capture();
+            this->write_batch();
+        }
+
+        // the capture follows the console reporter, or gets one of its own.
+        void attach_capture() {
+            if(!this->captured)
+                return;
+
+            for(auto& sink : this->sinks) {
+                if(dynamic_cast<console_reporter*>(sink->format.get()) != nullptr) {
+                    sink->outputs.push_back(this->captured.get());
+                    return;
+                }
+            }
+
+            this->sinks.push_back(std::make_unique<report_sink>());
+            this->sinks.back()->format = std::make_unique<console_reporter>();
+            this->sinks.back()->outputs.push_back(this->captured.get());
+        }
+
+        string keep(std::string text) {
+            auto owned = std::make_unique<std::string>(std::move(text));
+            const string view = *owned;
+
+            std::lock_guard<std::mutex> guard(this->kept_lock);
+            this->kept.emplace(view.data(), std::move(owned));
+            return view;
+        }
+
+        // frees the text of a kept record, once every sink formatted it (or
+        // an isolated worker sent it, or a resample threw it away).
+        void release(const record& entry) {
+            if(!entry.kept)
+                return;
+
+            std::lock_guard<std::mutex> guard(this->kept_lock);
+            this->kept.erase(entry.data.data());
+        }
+
+        // text outside of any record (summaries), to every console reporter.
+        void print(const string text) {
+            this->flush();
+
+            std::lock_guard<std::mutex> guard(this->state_lock);
+
+            for(auto& sink : this->sinks) {
+                if(dynamic_cast<console_reporter*>(sink->format.get()) != nullptr)
+                    sink->batch += text;
+            }
+
+            this->write_batch();
+        }
+
+        // closes every reporter's document after the last case.
+        void end(const unsigned errors, const unsigned passes, const std::uint64_t ns) {
+            this->flush();
+
+            std::lock_guard<std::mutex> guard(this->state_lock);
+
+            for(auto& sink : this->sinks)
+                sink->format->end(sink->batch, errors, passes, ns);
+
+            this->write_batch();
+        }
+
+        record_ring& ring() {
+            thread_local class holder {
+            public:
+                record_ring* ring = nullptr;
+
+                ~holder() {
+                    if(this->ring != nullptr)
+                        this->ring->in_use.store(false, std::memory_order_release);
+                }
+            } local;
+
+            if(local.ring == nullptr) {
+                std::lock_guard<std::mutex> guard(this->rings_lock);
+
+                for(auto& ring : this->rings) {
+                    if(!ring->in_use.load(std::memory_order_acquire) && ring->size() == 0) {
+                        ring->in_use.store(true, std::memory_order_relaxed);
+                        local.ring = ring.get();
+                        break;
+                    }
+                }
+
+                if(local.ring == nullptr) {
+                    this->rings.push_back(std::make_unique<record_ring>());
+                    local.ring = this->rings.back().get();
+                }
+            }
+
+            return *local.ring;
+        }
+
+        void push(const record& entry) {
+            auto& ring = this->ring();
+
+            while(!ring.push(entry)) {
+                if(!this->thread.joinable()) {
+                    this->drain();
+                    continue;
+                }
+
+                this->wake.notify_one();
+                std::this_thread::yield();
+            }
+
+            if(ring.size() == record_ring::capacity / 2)
+                this->wake.notify_one();
+        }
+
+        // blocks until everything pushed by the calling thread has been written.
+        void flush() {
+            #ifdef GECHTEST_HAS_FORK
+                if(::getpid() != this->owner)
+                    return;
+            #endif
+
+            if(!this->thread.joinable()) {
+                this->drain();
+                return;
+            }
+
+            std::unique_lock<std::mutex> guard(this->lock);
+            const auto ticket = ++this->requested;
+
+            this->wake.notify_one();
+            this->done.wait(guard, [&] { return this->completed >= ticket; });
+        }
+
+        // writes everything pushed so far on the calling thread, a serial run
+        // does so at every case end so a crash cannot take finished cases with it.
+        void sync() {
+            #ifdef GECHTEST_HAS_FORK
+                if(::getpid() != this->owner)
+                    return;
+            #endif
+
+            this->drain();
+        }
+
+        // last write from a thread taking the process down (fatal signal,
+        // std::terminate): the rings, then the text of cases still running,
+        // out of order if it must. not async-signal-safe, it is a best effort.
+        void salvage() {
+            #ifdef GECHTEST_HAS_FORK
+                if(::getpid() != this->owner)
+                    return;
+            #endif
+
+            if(this->salvaged.exchange(true))
+                return;
+
+            // the writer thread lets go after its drain; if this thread is the
+            // one holding them, there is nothing safe left to do.
+            bool locked = false;
+
+            for(int i = 0; i < 200 && !(locked = this->state_lock.try_lock()); ++i)
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            if(!locked)
+                return;
+
+            if(this->rings_lock.try_lock()) {
+                for(auto& ring : this->rings)
+                    ring->drain([this](const record& entry) { this->consume(entry); });
+
+                this->rings_lock.unlock();
+            }
+
+            for(auto& sink : this->sinks) {
+                for(std::size_t i = this->next_case; i < sink->pending.size(); ++i)
+                    sink->batch += sink->pending[i];
+
+                sink->pending.clear();
+            }
+
+            // kept locked, the writer thread must not write after this.
+            this->write_batch();
+        }
+
+        void run() {
+            std::unique_lock<std::mutex> guard(this->lock);
+
+            while(true) {
+                this->wake.wait_for(guard, std::chrono::milliseconds(1), [&] {
+                    return this->stop || this->requested != this->completed;
+                });
+
+                const auto ticket = this->requested;
+                const auto stopping = this->stop;
+
+                guard.unlock();
+                this->drain();
+                guard.lock();
+
+                this->completed = ticket;
+                this->done.notify_all();
+
+                if(stopping)
+                    break;
+            }
+        }
+
+        void drain() {
+            std::lock_guard<std::mutex> state(this->state_lock);
+
+            {
+                std::lock_guard<std::mutex> guard(this->rings_lock);
+                this->snapshot.clear();
+
+                for(auto& ring : this->rings)
+                    this->snapshot.push_back(ring.get());
+            }
+
+            for(auto ring : this->snapshot)
+                ring->drain([this](const record& entry) { this->consume(entry); });
+
+            this->write_batch();
+        }
+
+        void consume(const record& entry) {
+            const bool in_run = entry.case_index < this->ended.size();
+
+            for(auto& sink : this->sinks) {
+                auto& text = in_run ? sink->text(entry.case_index, this->next_case) : sink->batch;
+
+                if(entry.kind == CaseEnd)
+                    sink->format->case_end(text, entry);
+                else
+                    sink->format->assertion(text, entry);
+            }
+
+            this->release(entry);
+
+            if(in_run && entry.kind == CaseEnd) {
+                this->ended[entry.case_index] = true;
+
+                while(this->next_case < this->ended.size() && this->ended[this->next_case]) {
+                    for(auto& sink : this->sinks) {
+                        sink->batch += sink->pending[this->next_case];
+                        std::string().swap(sink->pending[this->next_case]);
+                    }
+
+                    ++this->next_case;
+                }
+            }
+
+            for(auto& sink : this->sinks) {
+                if(sink->batch.size() >= 1 << 16) {
+                    this->write_batch();
+                    break;
+                }
+            }
+        }
+
+        void write_batch() {
+            std::fflush(stdout);
+
+            for(auto& sink : this->sinks) {
+                if(sink->batch.empty())
+                    continue;
+
+                for(auto output : sink->outputs)
+                    output->write(sink->batch.data(), sink->batch.size());
+
+                sink->batch.clear();
+            }
+        }
+    };
+
+    inline log_writer& writer() {
+        static log_writer instance;
+        return instance;
+    }
+
+    inline std::terminate_handler previous_terminate = nullptr;
+
+    #ifdef GECHTEST_HAS_POSIX
+        inline void on_fatal(int signal) {
+            gech::writer().salvage();
+
+            ::signal(signal, SIG_DFL);
+            ::raise(signal);
+        }
+    #endif
+
+    // output still in the writer goes out before a crash or an escaped
+    // exception ends the process.
+    inline void watch_crashes() {
+        static std::once_flag once;
+
+        std::call_once(once, [] {
+            gech::previous_terminate = std::set_terminate([] {
+                gech::writer().salvage();
+
+                if(gech::previous_terminate != nullptr)
+                    gech::previous_terminate();
+
+                std::abort();
+            });
+
+            #ifdef GECHTEST_HAS_POSIX
+                struct sigaction action {};
+                action.sa_handler = gech::on_fatal;
+
+                for(const int signal : { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT })
+                    ::sigaction(signal, &action, nullptr);
+            #endif
+        });
+    }
+
+    // TEST_DATA.string_data, everything the console reporter wrote so far.
+    class string_capture {
+    public:
+        string_capture() = default; ~string_capture() = default;
+
+        std::string str() const {
+            gech::writer().flush();
+            return gech::writer().captured ? gech::writer().captured->str() : std::string();
+        }
+    };
+
+    #ifdef GECHTEST_HAS_FORK
+        static_assert(std::is_trivially_copyable_v<record> && std::is_trivially_copyable_v<bench_result>
+                   && std::is_trivially_copyable_v<perf_result> && std::is_trivially_copyable_v<baseline_entry>,
+                      "isolated workers send records and results to the parent as raw bytes");
+
+        // fixed part of a case result streamed from a worker process, followed by
+        // record_count records, bench_count bench results, perf_count perf
+        // results, baseline_count baseline entries, then text_size bytes of
+        // text for the kept records, in record order.
+        class result_header {
+        public:
+            std::uint64_t ms_took;
+            std::uint32_t index, errors, passes;
+            std::int32_t rc;
+            std::uint32_t record_count, bench_count, perf_count, baseline_count, text_size;
+
+            std::source_location current_location;
+        };
+
+        inline bool write_all(int fd, const void* data, std::size_t size) {
+            auto bytes = static_cast<const char*>(data);
+
+            while(size > 0) {
+                const auto written = ::write(fd, bytes, size);
+
+                if(written < 0 && errno == EINTR)
+                    continue;
+
+                if(written <= 0)
+                    return false;
+
+                bytes += written;
+                size -= written;
+            }
+
+            return true;
+        }
+
+        inline bool read_all(int fd, void* data, std::size_t size) {
+            auto bytes = static_cast<char*>(data);
+
+            while(size > 0) {
+                const auto got = ::read(fd, bytes, size);
+
+                if(got < 0 && errno == EINTR)
+                    continue;
+
+                if(got <= 0)
+                    return false;
+
+                bytes += got;
+                size -= got;
+            }
+
+            return true;
+        }
+
+        class worker_process {
+        public:
+            pid_t pid = -1;
+            int results = -1;
+
+            // registry indices owned by this worker, results arrive in this order.
+            std::vector<std::uint32_t> shard;
+            std::size_t next = 0;
+        public:
+            worker_process() = default; ~worker_process() = default;
+        };
+    #endif
+
+    // offset of the first byte that differs, size if there is none. 32 (avx2)
+    // or 16 (sse2) bytes a step, what is left over one at a time.
+    inline std::size_t first_mismatch(const void* lhs, const void* rhs, const std::size_t size) noexcept {
+        const auto a = static_cast<const unsigned char*>(lhs);
+        const auto b = static_cast<const unsigned char*>(rhs);
+        std::size_t i = 0;
+
+        #ifdef GECHTEST_HAS_AVX2
+            for(; i + 32 <= size; i += 32) {
+                const auto equal = _mm256_cmpeq_epi8(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i)),
+                                                     _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i)));
+                const auto differ = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(equal));
+
+                if(differ != 0)
+                    return i + std::countr_zero(differ);
+            }
+        #endif
+
+        #ifdef GECHTEST_HAS_SSE2
+            for(; i + 16 <= size; i += 16) {
+                const auto equal = _mm_cmpeq_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i)),
+                                                  _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i)));
+                const auto differ = ~static_cast<std::uint32_t>(_mm_movemask_epi8(equal)) & 0xffff;
+
+                if(differ != 0)
+                    return i + std::countr_zero(differ);
+            }
+        #endif
+
+        for(; i < size; ++i) {
+            if(a[i] != b[i])
+                return i;
+        }
+
+        return size;
+    }
+
+    enum tolerance_kinds {
+        Absolute,
+        Relative,
+        Ulp
+    };
+
+    // floating point bit patterns as integers in the order of their values,
+    // so ulp distance is a subtraction. -0 and +0 both map to 0.
+    template <typename Float>
+    inline std::int64_t ordered_bits(const Float value) noexcept {
+        if constexpr(std::is_same_v<Float, float>) {
+            const auto bits = std::bit_cast<std::int32_t>(value);
+            return bits < 0 ? std::int64_t(INT32_MIN) - bits : bits;
+        } else {
+            const auto bits = std::bit_cast<std::int64_t>(value);
+            return bits < 0 ? INT64_MIN - bits : bits;
+        }
+    }
+
+    template <typename Float>
+    inline std::uint64_t ulp_distance(const Float lhs, const Float rhs) noexcept {
+        const auto a = gech::ordered_bits(lhs), b = gech::ordered_bits(rhs);
+        return a >= b ? std::uint64_t(a) - std::uint64_t(b) : std::uint64_t(b) - std::uint64_t(a);
+    }
+
+    // the check itself, the vector kernels below do exactly this per lane.
+    // nan is never near anything here; a nan in both operands only passes
+    // on the cold path, through near_error(). the relative bound scales by
+    // the larger magnitude capped at the largest finite value, so an infinity
+    // is only near itself.
+    template <tolerance_kinds Kind, typename Float>
+    inline bool near(const Float lhs, const Float rhs, const double tolerance) noexcept {
+        if(std::isnan(lhs) || std::isnan(rhs))
+            return false;
+
+        if constexpr(Kind == Ulp)
+            return gech::ulp_distance(lhs, rhs) <= static_cast<std::uint64_t>(tolerance);
+        else if constexpr(Kind == Absolute)
+            return lhs == rhs || std::fabs(lhs - rhs) <= static_cast<Float>(tolerance);
+        else
+            return lhs == rhs || std::fabs(lhs - rhs) <= static_cast<Float>(tolerance)
+                                  * std::min(std::max(std::fabs(lhs), std::fabs(rhs)), std::numeric_limits<Float>::max());
+    }
+
+    // what a failure reports: the absolute, relative or ulp error, infinite
+    // for nan against a number, 0 for nan against nan.
+    template <tolerance_kinds Kind, typename Float>
+    inline double near_error(const Float lhs, const Float rhs) noexcept {
+        if(std::isnan(lhs) || std::isnan(rhs))
+            return std::isnan(lhs) && std::isnan(rhs) ? 0 : HUGE_VAL;
+
+        if(lhs == rhs)
+            return 0;
+
+        if constexpr(Kind == Ulp)
+            return static_cast<double>(gech::ulp_distance(lhs, rhs));
+        else if constexpr(Kind == Absolute)
+            return std::fabs(static_cast<double>(lhs) - rhs);
+        else
+            return std::fabs(static_cast<double>(lhs) - rhs) / std::min(std::max(std::fabs(static_cast<double>(lhs)), std::fabs(static_cast<double>(rhs))),
+                                                                         std::numeric_limits<double>::max());
+    }
+
+    #ifdef GECHTEST_HAS_SSE2
+        // lanes of one step that are not near, as a movemask.
+        template <tolerance_kinds Kind>
+        inline int far_lanes(const __m128 a, const __m128 b, const __m128 tolerance, const __m128i ulps) noexcept {
+            if constexpr(Kind == Ulp) {
+                const auto order = [](const __m128i bits) {
+                    const auto negative = _mm_srai_epi32(bits, 31);
+                    const auto flipped = _mm_sub_epi32(_mm_set1_epi32(INT32_MIN), bits);
+                    return _mm_or_si128(_mm_and_si128(negative, flipped), _mm_andnot_si128(negative, bits));
+                };
+
+                const auto x = order(_mm_castps_si128(a)), y = order(_mm_castps_si128(b));
+                const auto distance = _mm_sub_epi32(x, y);
+                const auto overflow = _mm_and_si128(_mm_xor_si128(x, y), _mm_xor_si128(x, distance));
+                const auto sign = _mm_srai_epi32(distance, 31);
+                const auto size = _mm_sub_epi32(_mm_xor_si128(distance, sign), sign);
+                const auto far = _mm_or_si128(_mm_or_si128(_mm_srai_epi32(overflow, 31), _mm_srai_epi32(size, 31)),
+                                              _mm_cmpgt_epi32(size, ulps));
+
+                return _mm_movemask_ps(_mm_or_ps(_mm_castsi128_ps(far), _mm_cmpunord_ps(a, b)));
+            } else {
+                const auto magnitude = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+                const auto error = _mm_and_ps(_mm_sub_ps(a, b), magnitude);
+                auto bound = tolerance;
+
+                if constexpr(Kind == Relative)
+                    bound = _mm_mul_ps(tolerance, _mm_min_ps(_mm_max_ps(_mm_and_ps(a, magnitude), _mm_and_ps(b, magnitude)),
+                                                             _mm_set1_ps(std::numeric_limits<float>::max())));
+
+                return _mm_movemask_ps(_mm_andnot_ps(_mm_or_ps(_mm_cmpeq_ps(a, b), _mm_cmple_ps(error, bound)),
+                                                     _mm_castsi128_ps(_mm_set1_epi32(-1))));
+            }
+        }
+
+        template <tolerance_kinds Kind>
+        inline int far_lanes(const __m128d a, const __m128d b, const __m128d tolerance) noexcept {
+            const auto magnitude = _mm_castsi128_pd(_mm_set1_epi64x(0x7fffffffffffffff));
+            const auto error = _mm_and_pd(_mm_sub_pd(a, b), magnitude);
+            auto bound = tolerance;
+
+            if constexpr(Kind == Relative)
+                bound = _mm_mul_pd(tolerance, _mm_min_pd(_mm_max_pd(_mm_and_pd(a, magnitude), _mm_and_pd(b, magnitude)),
+                                                         _mm_set1_pd(std::numeric_limits<double>::max())));
+
+            return _mm_movemask_pd(_mm_andnot_pd(_mm_or_pd(_mm_cmpeq_pd(a, b), _mm_cmple_pd(error, bound)),
+                                                 _mm_castsi128_pd(_mm_set1_epi32(-1))));
+        }
+    #endif
+
+    #ifdef GECHTEST_HAS_AVX2
+        template <tolerance_kinds Kind>
+        inline int far_lanes(const __m256 a, const __m256 b, const __m256 tolerance, const __m256i ulps) noexcept {
+            if constexpr(Kind == Ulp) {
+                const auto order = [](const __m256i bits) {
+                    return _mm256_blendv_epi8(bits, _mm256_sub_epi32(_mm256_set1_epi32(INT32_MIN), bits), _mm256_srai_epi32(bits, 31));
+                };
+
+                const auto x = order(_mm256_castps_si256(a)), y = order(_mm256_castps_si256(b));
+                const auto distance = _mm256_sub_epi32(x, y);
+                const auto overflow = _mm256_and_si256(_mm256_xor_si256(x, y), _mm256_xor_si256(x, distance));
+                const auto size = _mm256_abs_epi32(distance);
+                const auto far = _mm256_or_si256(_mm256_or_si256(overflow, size), _mm256_cmpgt_epi32(size, ulps));
+
+                return _mm256_movemask_ps(_mm256_or_ps(_mm256_castsi256_ps(far), _mm256_cmp_ps(a, b, _CMP_UNORD_Q)));
+            } else {
+                const auto magnitude = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+                const auto error = _mm256_and_ps(_mm256_sub_ps(a, b), magnitude);
+                auto bound = tolerance;
+
+                if constexpr(Kind == Relative)
+                    bound = _mm256_mul_ps(tolerance, _mm256_min_ps(_mm256_max_ps(_mm256_and_ps(a, magnitude), _mm256_and_ps(b, magnitude)),
+                                                                   _mm256_set1_ps(std::numeric_limits<float>::max())));
+
+                return ~_mm256_movemask_ps(_mm256_or_ps(_mm256_cmp_ps(a, b, _CMP_EQ_OQ), _mm256_cmp_ps(error, bound, _CMP_LE_OQ))) & 0xff;
+            }
+        }
+
+        template <tolerance_kinds Kind>
+        inline int far_lanes(const __m256d a, const __m256d b, const __m256d tolerance, const __m256i ulps) noexcept {
+            if constexpr(Kind == Ulp) {
+                const auto zero = _mm256_setzero_si256();
+                const auto order = [zero](const __m256i bits) {
+                    return _mm256_blendv_epi8(bits, _mm256_sub_epi64(_mm256_set1_epi64x(INT64_MIN), bits), _mm256_cmpgt_epi64(zero, bits));
+                };
+
+                const auto x = order(_mm256_castpd_si256(a)), y = order(_mm256_castpd_si256(b));
+                const auto distance = _mm256_sub_epi64(x, y);
+                const auto overflow = _mm256_and_si256(_mm256_xor_si256(x, y), _mm256_xor_si256(x, distance));
+                const auto sign = _mm256_cmpgt_epi64(zero, distance);
+                const auto size = _mm256_sub_epi64(_mm256_xor_si256(distance, sign), sign);
+                const auto far = _mm256_or_si256(_mm256_or_si256(overflow, size), _mm256_cmpgt_epi64(size, ulps));
+
+                return _mm256_movemask_pd(_mm256_or_pd(_mm256_castsi256_pd(far), _mm256_cmp_pd(a, b, _CMP_UNORD_Q)));
+            } else {
+                const auto magnitude = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffff));
+                const auto error = _mm256_and_pd(_mm256_sub_pd(a, b), magnitude);
+                auto bound = tolerance;
+
+                if constexpr(Kind == Relative)
+                    bound = _mm256_mul_pd(tolerance, _mm256_min_pd(_mm256_max_pd(_mm256_and_pd(a, magnitude), _mm256_and_pd(b, magnitude)),
+                                                                   _mm256_set1_pd(std::numeric_limits<double>::max())));
+
+                return ~_mm256_movemask_pd(_mm256_or_pd(_mm256_cmp_pd(a, b, _CMP_EQ_OQ), _mm256_cmp_pd(error, bound, _CMP_LE_OQ))) & 0xf;
+            }
+        }
+    #endif
+
+    // whether every element pair is near(), stopping at the first vector step
+    // that is not. the pass path of the array assertions.
+    template <tolerance_kinds Kind, typename Float>
+    inline bool all_near(const Float* a, const Float* b, const std::size_t count, const double tolerance) noexcept {
+        std::size_t i = 0;
+
+        [[maybe_unused]] const auto ulps = static_cast<std::int64_t>(std::min(tolerance, std::is_same_v<Float, float> ? 2147483647.0 : 9.2e18));
+
+        #ifdef GECHTEST_HAS_AVX2
+            if constexpr(std::is_same_v<Float, float>) {
+                const auto bound = _mm256_set1_ps(static_cast<float>(tolerance));
+                const auto ulp = _mm256_set1_epi32(static_cast<std::int32_t>(ulps));
+
+                for(; i + 8 <= count; i += 8) {
+                    if(gech::far_lanes<Kind>(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), bound, ulp) != 0)
+                        return false;
+                }
+            } else {
+                const auto bound = _mm256_set1_pd(tolerance);
+                const auto ulp = _mm256_set1_epi64x(ulps);
+
+                for(; i + 4 <= count; i += 4) {
+                    if(gech::far_lanes<Kind>(_mm256_loadu_pd(a + i), _mm256_loadu_pd(b + i), bound, ulp) != 0)
+                        return false;
+                }
+            }
+        #elif defined(GECHTEST_HAS_SSE2)
+            // no 64-bit lane compares before sse4.2, double ulps stay scalar.
+            if constexpr(std::is_same_v<Float, float>) {
+                const auto bound = _mm_set1_ps(static_cast<float>(tolerance));
+                const auto ulp = _mm_set1_epi32(static_cast<std::int32_t>(ulps));
+
+                for(; i + 4 <= count; i += 4) {
+                    if(gech::far_lanes<Kind>(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i), bound, ulp) != 0)
+                        return false;
+                }
+            } else if constexpr(Kind != Ulp) {
+                const auto bound = _mm_set1_pd(tolerance);
+
+                for(; i + 2 <= count; i += 2) {
+                    if(gech::far_lanes<Kind>(_mm_loadu_pd(a + i), _mm_loadu_pd(b + i), bound) != 0)
+                        return false;
+                }
+            }
+        #endif
+
+        for(; i < count; ++i) {
+            if(!gech::near<Kind>(a[i], b[i], tolerance))
+                return false;
+        }
+
+        return true;
+    }
+
+    // containers print at most this many elements, strings this many characters.
+    inline constexpr std::size_t print_limit = 32, print_string_limit = 256;
+
+    template <typename Val>
+    class printer;
+
+    template <typename Val>
+    void print_value(std::string& text, const Val& value) {
+        gech::printer<Val>::print(text, value);
+    }
+
+    template <typename Val>
+    class is_optional : public std::false_type {};
+
+    template <typename Val>
+    class is_optional<std::optional<Val>> : public std::true_type {};
+
+    // a range of itself (std::filesystem::path) would never bottom out when
+    // printed element by element.
+    template <typename Val>
+    class is_self_range : public std::false_type {};
+
+    template <std::ranges::input_range Val>
+    class is_self_range<Val> : public std::is_same<std::remove_cvref_t<std::ranges::range_value_t<Val>>,
+                                                   std::remove_cvref_t<Val>> {};
+
+    inline void print_string(std::string& text, const std::string_view value) {
+        text += '"';
+        text.append(value.substr(0, print_string_limit));
+
+        if(value.size() > print_string_limit) {
+            text += "\"... +";
+            gech::append_number(text, value.size() - print_string_limit);
+            text += " more";
+            return;
+        }
+
+        text += '"';
+    }
+
+    // how a failed assertion shows an operand. specialize gech::printer<T>, or
+    // give the type a gech_print(std::string&, const T&) found by ADL; the rest
+    // prints whatever it can tell about it. only failures get here.
+    template <typename Val>
+    class printer {
+    public:
+        static void print(std::string& text, const Val& value) {
+            if constexpr(requires { gech_print(text, value); })
+                gech_print(text, value);
+            else if constexpr(std::is_same_v<Val, bool>)
+                text += value ? "true" : "false";
+            else if constexpr(std::is_same_v<Val, char>) {
+                text += '\'';
+                text += value;
+                text += '\'';
+            } else if constexpr(std::is_arithmetic_v<Val>)
+                gech::append_number(text, value);
+            else if constexpr(std::is_enum_v<Val>)
+                gech::append_number(text, static_cast<std::underlying_type_t<Val>>(value));
+            else if constexpr(std::is_null_pointer_v<Val>)
+                text += "nullptr";
+            else if constexpr(std::is_convertible_v<const Val&, std::string_view>) {
+                // a null const char* is still a pointer.
+                if constexpr(std::is_pointer_v<Val>) {
+                    if(value == nullptr) {
+                        text += "nullptr";
+                        return;
+                    }
+                }
+
+                gech::print_string(text, value);
+            } else if constexpr(std::is_pointer_v<Val> || std::is_member_pointer_v<Val>) {
+                if constexpr(std::is_member_pointer_v<Val>)
+                    text += value == nullptr ? "nullptr" : "member pointer";
+                else if(value == nullptr)
+                    text += "nullptr";
+                else {
+                    char buffer[2 * sizeof(std::uintptr_t)];
+                    const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer),
+                                                            reinterpret_cast<std::uintptr_t>(value), 16);
+                    text += "0x";
+                    text.append(buffer, end);
+                }
+            } else if constexpr(gech::is_optional<Val>::value) {
+                if(!value.has_value()) {
+                    text += "nullopt";
+                    return;
+                }
+
+                text += "optional(";
+                gech::print_value(text, *value);
+                text += ')';
+            } else if constexpr(std::ranges::input_range<const Val> && !gech::is_self_range<const Val>::value) {
+                std::size_t count = 0;
+                text += '[';
+
+                for(const auto& element : value) {
+                    if(count == print_limit) {
+                        text += ", ...";
+
+                        if constexpr(std::ranges::sized_range<const Val>) {
+                            text += " +";
+                            gech::append_number(text, std::ranges::size(value) - print_limit);
+                            text += " more";
+                        }
+
+                        break;
+                    }
+
+                    if(count++ != 0)
+                        text += ", ";
+
+                    gech::print_value(text, element);
+                }
+
+                text += ']';
+            } else if constexpr(requires { std::tuple_size<Val>::value; }) {
+                text += '(';
+
+                std::apply([&text](const auto&... element) {
+                    std::size_t count = 0;
+                    ((text += count++ != 0 ? ", " : "", gech::print_value(text, element)), ...);
+                }, value);
+
+                text += ')';
+            } else if constexpr(requires(std::ostream& out) { out << value; }) {
+                std::ostringstream out;
+                out << value;
+                text += out.str();
+            } else {
+                text += '{';
+                gech::append_number(text, sizeof(Val));
+                text += "-byte object}";
+            }
+        }
+    };
+
+    // in front of every block handed out while TEST_TRACK_ALLOC is on. blocks
+    // allocated inside a case are linked into its scope until freed.
+    class alignas(16) alloc_header {
+    public:
+        static constexpr std::uint64_t tracked = 0x6765636874657374;
+
+        alloc_scope* scope;
+        alloc_header *prev, *next;
+
+        // what the raw allocator returned, the header may sit further in for alignment.
+        void* base;
+        std::size_t size;
+
+        // return address of the allocating call.
+        void* site;
+        std::uint64_t magic;
+    };
+
+    // live blocks of one running case. frees can come from any thread, so
+    // the list is behind a spin lock; it is almost never contended.
+    class alloc_scope {
+    public:
+        std::atomic_flag lock = ATOMIC_FLAG_INIT;
+        alloc_header* head = nullptr;
+        std::size_t live_bytes = 0, live_count = 0;
+    public:
+        alloc_scope() = default; ~alloc_scope() = default;
+
+        void acquire() noexcept {
+            while(this->lock.test_and_set(std::memory_order_acquire))
+                ;
+        }
+
+        void release() noexcept {
+            this->lock.clear(std::memory_order_release);
+        }
+    };
+
+    // scope of the case the calling thread runs, and a counter that keeps
+    // gechtest's own bookkeeping (records, failure text) out of it.
+    inline thread_local alloc_scope* alloc_current = nullptr;
+    inline thread_local unsigned alloc_paused = 0;
+
+    // stops tracking on this thread while alive; nothing without TEST_TRACK_ALLOC.
+    class alloc_pause {
+    public:
+        #ifdef TEST_TRACK_ALLOC
+            alloc_pause() noexcept { ++gech::alloc_paused; }
+            ~alloc_pause() { --gech::alloc_paused; }
+        #else
+            alloc_pause() noexcept {} ~alloc_pause() {}
+        #endif
+    };
+
+    #ifdef TEST_TRACK_ALLOC
+        #ifdef GECHTEST_TRACK_MALLOC
+            inline void* raw_malloc(const std::size_t size) noexcept { return __real_malloc(size); }
+            inline void raw_free(void* pointer) noexcept { __real_free(pointer); }
+        #else
+            inline void* raw_malloc(const std::size_t size) noexcept { return std::malloc(size); }
+            inline void raw_free(void* pointer) noexcept { std::free(pointer); }
+        #endif
+
+        inline alloc_header* header_of(void* pointer) noexcept {
+            return static_cast<alloc_header*>(pointer) - 1;
+        }
+
+        inline void* tracked_alloc(const std::size_t size, std::size_t align, void* site) noexcept {
+            align = std::max(align, alignof(alloc_header));
+
+            const auto base = static_cast<char*>(gech::raw_malloc(size + sizeof(alloc_header) + align - alignof(alloc_header)));
+
+            if(base == nullptr)
+                return nullptr;
+
+            const auto at = reinterpret_cast<std::uintptr_t>(base + sizeof(alloc_header));
+            const auto user = reinterpret_cast<void*>((at + align - 1) & ~(std::uintptr_t(align) - 1));
+            const auto header = gech::header_of(user);
+
+            header->base = base;
+            header->size = size;
+            header->site = site;
+            header->magic = alloc_header::tracked;
+            header->scope = gech::alloc_paused == 0 ? gech::alloc_current : nullptr;
+
+            if(const auto scope = header->scope) {
+                scope->acquire();
+                header->prev = nullptr;
+                header->next = scope->head;
+
+                if(scope->head != nullptr)
+                    scope->head->prev = header;
+
+                scope->head = header;
+                scope->live_bytes += size;
+                ++scope->live_count;
+                scope->release();
+            }
+
+            return user;
+        }
+
+        inline void tracked_free(void* pointer) noexcept {
+            if(pointer == nullptr)
+                return;
+
+            const auto header = gech::header_of(pointer);
+
+            // the scope pointer is only cleared under the scope's own lock.
+            if(auto scope = header->scope) {
+                scope->acquire();
+
+                if(header->scope == scope) {
+                    if(header->prev != nullptr)
+                        header->prev->next = header->next;
+                    else
+                        scope->head = header->next;
+
+                    if(header->next != nullptr)
+                        header->next->prev = header->prev;
+
+                    scope->live_bytes -= header->size;
+                    --scope->live_count;
+                }
+
+                scope->release();
+            }
+
+            header->magic = 0;
+            gech::raw_free(header->base);
+        }
+
+        // "symbol+0x1c" or "module+0x1234" for a return address.
+        inline void print_site(std::string& text, void* site) {
+            #ifdef GECHTEST_HAS_DLADDR
+                Dl_info info;
+
+                if(::dladdr(site, &info) != 0) {
+                    const auto offset = [&](const void* from) {
+                        char buffer[2 * sizeof(std::uintptr_t)];
+                        const auto [end, error] = std::to_chars(buffer, buffer + sizeof(buffer),
+                            reinterpret_cast<std::uintptr_t>(site) - reinterpret_cast<std::uintptr_t>(from), 16);
+                        text += "+0x";
+                        text.append(buffer, end);
+                    };
+
+                    if(info.dli_sname != nullptr) {
+                        int status = 0;
+                        const auto name = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+                        text += status == 0 ? name : info.dli_sname;
+                        std::free(name);
+                        offset(info.dli_saddr);
+                        return;
+                    }
+
+                    if(info.dli_fname != nullptr) {
+                        text += info.dli_fname;
+                        offset(info.dli_fbase);
+                        return;
+                    }
+                }
+            #endif
+
+            gech::print_value(text, site);
+        }
+    #endif
+
+    // splitmix64, PROPERTY() draws every input from one of these.
+    class rng {
+    public:
+        std::uint64_t state;
+    public:
+        explicit rng(const std::uint64_t seed) noexcept : state(seed) {}
+        ~rng() = default;
+
+        std::uint64_t next() noexcept {
+            auto z = (this->state += 0x9e3779b97f4a7c15);
+            z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
+            z = (z ^ (z >> 27)) * 0x94d049bb133111eb;
+            return z ^ (z >> 31);
+        }
+
+        // uniform enough in [0, span].
+        std::uint64_t upto(const std::uint64_t span) noexcept {
+            return span == std::numeric_limits<std::uint64_t>::max() ? this->next() : this->next() % (span + 1);
+        }
+
+        // in [0, 1).
+        double unit() noexcept {
+            return static_cast<double>(this->next() >> 11) * 0x1p-53;
+        }
+    };
+
+    // a generator has a value_type, generate(out, rng, size) that fills out
+    // in place (so a vector keeps its capacity from run to run) and
+    // shrinks(value), simpler values to try once value falsified a property.
+    // size grows from 0 to the run count and bounds how big a value gets.
+    namespace gen {
+        // uniform in [lo, hi]; one draw in eight is lo, hi or the origin.
+        // shrinks toward the origin, 0 or the bound closest to it.
+        template <typename T>
+        class integer_gen {
+            using unsigned_type = std::make_unsigned_t<T>;
+        public:
+            using value_type = T;
+
+            T lo, hi;
+        public:
+            constexpr integer_gen(const T lo, const T hi) noexcept : lo(lo), hi(hi) {}
+            ~integer_gen() = default;
+
+            constexpr T origin() const noexcept {
+                return this->lo > 0 ? this->lo : (this->hi < 0 ? this->hi : T(0));
+            }
+
+            void generate(T& out, gech::rng& rng, std::size_t) const noexcept {
+                const auto draw = rng.next();
+
+                if((draw & 7) == 0) {
+                    const T edges[3] { this->lo, this->hi, this->origin() };
+                    out = edges[(draw >> 3) % 3];
+                    return;
+                }
+
+                const auto span = static_cast<unsigned_type>(static_cast<unsigned_type>(this->hi) - static_cast<unsigned_type>(this->lo));
+                out = static_cast<T>(static_cast<unsigned_type>(this->lo) + static_cast<unsigned_type>(rng.upto(span)));
+            }
+
+            // the origin, then halfway there, a quarter of the way, ... one step.
+            std::vector<T> shrinks(const T value) const {
+                std::vector<T> out;
+                const auto origin = this->origin();
+
+                if(value == origin)
+                    return out;
+
+                out.push_back(origin);
+
+                const auto above = value > origin;
+                const auto distance = above
+                                      ? static_cast<unsigned_type>(static_cast<unsigned_type>(value) - static_cast<unsigned_type>(origin))
+                                      : static_cast<unsigned_type>(static_cast<unsigned_type>(origin) - static_cast<unsigned_type>(value));
+
+                for(auto step = static_cast<unsigned_type>(distance / 2); step != 0; step /= 2)
+                    out.push_back(static_cast<T>(above ? static_cast<unsigned_type>(value) - step
+                                                       : static_cast<unsigned_type>(value) + step));
+
+                return out;
+            }
+        };
+
+        // uniform in [lo, hi], with lo, hi and the origin drawn now and then.
+        template <typename T>
+        class real_gen {
+        public:
+            using value_type = T;
+
+            T lo, hi;
+        public:
+            constexpr real_gen(const T lo, const T hi) noexcept : lo(lo), hi(hi) {}
+            ~real_gen() = default;
+
+            constexpr T origin() const noexcept {
+                return this->lo > 0 ? this->lo : (this->hi < 0 ? this->hi : T(0));
+            }
+
+            void generate(T& out, gech::rng& rng, std::size_t) const noexcept {
+                const auto draw = rng.next();
+
+                if((draw & 7) == 0) {
+                    const T edges[3] { this->lo, this->hi, this->origin() };
+                    out = edges[(draw >> 3) % 3];
+                    return;
+                }
+
+                // never hi - lo, it overflows over the whole range.
+                const auto at = static_cast<T>(rng.unit());
+                out = std::clamp(this->lo * (1 - at) + this->hi * at, this->lo, this->hi);
+            }
+
+            std::vector<T> shrinks(const T value) const {
+                std::vector<T> out;
+                const auto origin = this->origin();
+
+                if(value == origin || std::isnan(value))
+                    return out;
+
+                out.push_back(origin);
+
+                if(const auto whole = std::trunc(value); whole != value && whole >= this->lo && whole <= this->hi)
+                    out.push_back(whole);
+
+                if(const auto half = origin + (value - origin) / 2; half != value && half != origin)
+                    out.push_back(half);
+
+                return out;
+            }
+        };
+
+        class bool_gen {
+        public:
+            using value_type = bool;
+        public:
+            bool_gen() = default; ~bool_gen() = default;
+
+            void generate(bool& out, gech::rng& rng, std::size_t) const noexcept {
+                out = rng.next() & 1;
+            }
+
+            std::vector<bool> shrinks(const bool value) const {
+                return value ? std::vector<bool> { false } : std::vector<bool>();
+            }
+        };
+
+        // one of a fixed list, shrinks toward the front of it.
+        template <typename T>
+        class element_gen {
+        public:
+            using value_type = T;
+
+            std::vector<T> values;
+        public:
+            explicit element_gen(std::vector<T> values) : values(std::move(values)) {}
+            ~element_gen() = default;
+
+            void generate(T& out, gech::rng& rng, std::size_t) const {
+                out = this->values[rng.upto(this->values.size() - 1)];
+            }
+
+            std::vector<T> shrinks(const T& value) const {
+                const auto found = std::find(this->values.begin(), this->values.end(), value);
+                return std::vector<T>(this->values.begin(), found);
+            }
+        };
+
+        // vectors and strings of min_size to max_size elements from element.
+        // shrinks by dropping halves, quarters, ... single elements, then by
+        // shrinking one element at a time.
+        template <typename Container, typename Gen>
+        class sequence_gen {
+        public:
+            using value_type = Container;
+
+            Gen element;
+            std::size_t min_size, max_size;
+        public:
+            sequence_gen(Gen element, const std::size_t min_size, const std::size_t max_size)
+                : element(std::move(element)), min_size(min_size), max_size(std::max(min_size, max_size)) {}
+            ~sequence_gen() = default;
+
+            void generate(Container& out, gech::rng& rng, const std::size_t size) const {
+                const auto most = std::clamp(size, this->min_size, this->max_size);
+                out.resize(this->min_size + rng.upto(most - this->min_size));
+
+                for(auto&& item : out) {
+                    // vector<bool> hands out proxies, everything else is filled in place.
+                    if constexpr(std::is_same_v<typename Container::reference, typename Gen::value_type&>)
+                        this->element.generate(item, rng, size);
+                    else {
+                        typename Gen::value_type value = item;
+                        this->element.generate(value, rng, size);
+                        item = value;
+                    }
+                }
+            }
+
+            std::vector<Container> shrinks(const Container& value) const {
+                std::vector<Container> out;
+                const auto length = value.size();
+
+                for(auto chunk = length / 2; chunk != 0; chunk /= 2) {
+                    // too big a cut for min_size, a smaller one may still fit.
+                    if(length - chunk < this->min_size)
+                        continue;
+
+                    for(std::size_t at = 0; at + chunk <= length; at += chunk) {
+                        Container smaller(value.begin(), value.begin() + at);
+                        smaller.insert(smaller.end(), value.begin() + at + chunk, value.end());
+                        out.push_back(std::move(smaller));
+                    }
+                }
+
+                if(length == 1 && this->min_size == 0)
+                    out.emplace_back();
+
+                for(std::size_t at = 0; at < length; ++at) {
+                    for(auto&& item : this->element.shrinks(value[at])) {
+                        Container simpler(value);
+                        simpler[at] = std::move(item);
+                        out.push_back(std::move(simpler));
+                    }
+                }
+
+                return out;
+            }
+        };
+
+        template <typename T = int>
+        constexpr integer_gen<T> integer(const T lo = std::numeric_limits<T>::min(),
+                                         const T hi = std::numeric_limits<T>::max()) noexcept {
+            return integer_gen<T>(lo, hi);
+        }
+
+        template <typename T = double>
+        constexpr real_gen<T> real(const T lo = std::numeric_limits<T>::lowest(),
+                                   const T hi = std::numeric_limits<T>::max()) noexcept {
+            return real_gen<T>(lo, hi);
+        }
+
+        inline bool_gen boolean() noexcept {
+            return bool_gen();
+        }
+
+        template <typename... Val>
+        element_gen<std::common_type_t<Val...>> element(const Val&... values) {
+            return element_gen<std::common_type_t<Val...>>({ values... });
+        }
+
+        template <typename Gen>
+        sequence_gen<std::vector<typename Gen::value_type>, Gen> vector(Gen element, const std::size_t max_size = 64,
+                                                                         const std::size_t min_size = 0) {
+            return { std::move(element), min_size, max_size };
+        }
+
+        // printable ascii.
+        inline sequence_gen<std::string, integer_gen<char>> string(const std::size_t max_size = 64,
+                                                                   const std::size_t min_size = 0) {
+            return { gen::integer<char>(' ', '~'), min_size, max_size };
+        }
+    }
+
+    // simpler inputs a falsified PROPERTY() accepts at most before reporting.
+    inline constexpr unsigned max_shrinks = 1000;
+
+    // what a PROPERTY() body takes, one value per generator.
+    template <typename Gens>
+    class property_values;
+
+    template <typename... Gens>
+    class property_values<std::tuple<Gens...>> {
+    public:
+        using type = std::tuple<typename Gens::value_type...>;
+    };
+
+    template <typename Gens>
+    using property_args = typename property_values<std::remove_cvref_t<Gens>>::type;
+
+    // edge counters filled by the TEST_FUZZ coverage callbacks while a fuzz
+    // input runs. touched lists the counters that became nonzero, so reading
+    // and clearing them costs what the input covered, not the whole map.
+    class coverage_map {
+    public:
+        static constexpr std::size_t size = 1 << 16;
+
+        std::uint8_t counters[size] {};
+        std::uint16_t touched[size] {};
+        std::size_t touched_count = 0;
+
+        // guards handed out by trace-pc-guard so far.
+        std::uint32_t guards = 0;
+    public:
+        coverage_map() = default; ~coverage_map() = default;
+
+        // new if any counter reached a bucket (1, 2, 3, 4+, 8+, 16+, 32+, 128+
+        // hits) seen has no bit for yet. clears the counters either way.
+        bool take(std::vector<std::uint8_t>& seen, std::size_t& edges) noexcept {
+            bool novel = false;
+
+            for(std::size_t i = 0; i < this->touched_count; ++i) {
+                const auto index = this->touched[i];
+                const auto hits = this->counters[index];
+
+                const std::uint8_t bucket = hits >= 128 ? 128 : hits >= 32 ? 64 : hits >= 16 ? 32 : hits >= 8 ? 16
+                                          : hits >= 4 ? 8 : hits == 3 ? 4 : hits == 2 ? 2 : 1;
+
+                if((seen[index] & bucket) == 0) {
+                    edges += seen[index] == 0;
+                    seen[index] |= bucket;
+                    novel = true;
+                }
+
+                this->counters[index] = 0;
+            }
+
+            this->touched_count = 0;
+            return novel;
+        }
+    };
+
+    // one map per process, coverage callbacks have nowhere else to write.
+    inline coverage_map coverage;
+
+    // only set on the thread running a fuzz target, which holds fuzz_lock();
+    // cases running beside it under -j leave the map alone.
+    inline thread_local bool coverage_tracing = false;
+
+    GECHTEST_NO_COVERAGE inline void cover(const std::size_t index) noexcept {
+        if(!gech::coverage_tracing)
+            return;
+
+        auto& counter = gech::coverage.counters[index];
+
+        if(counter == 0 && gech::coverage.touched_count < coverage_map::size)
+            gech::coverage.touched[gech::coverage.touched_count++] = static_cast<std::uint16_t>(index);
+
+        if(counter != 255)
+            ++counter;
+    }
+
+    // fuzz targets share the map, so -j fuzzes one at a time.
+    inline std::mutex& fuzz_lock() {
+        static std::mutex lock;
+        return lock;
+    }
+
+    inline std::uint64_t fnv1a(const void* data, const std::size_t size) noexcept {
+        auto bytes = static_cast<const unsigned char*>(data);
+        std::uint64_t hash = 0xcbf29ce484222325;
+
+        for(std::size_t i = 0; i < size; ++i)
+            hash = (hash ^ bytes[i]) * 0x100000001b3;
+
+        return hash;
+    }
+
+    // every regular file of a corpus directory, in name order.
+    inline std::vector<std::vector<std::uint8_t>> load_corpus(const std::filesystem::path& directory,
+                                                              std::vector<std::string>* names = nullptr) {
+        std::vector<std::vector<std::uint8_t>> inputs;
+        std::vector<std::filesystem::path> files;
+        std::error_code error;
+
+        for(const auto& entry : std::filesystem::directory_iterator(directory, error)) {
+            if(entry.is_regular_file(error))
+                files.push_back(entry.path());
+        }
+
+        std::sort(files.begin(), files.end());
+
+        for(const auto& file : files) {
+            std::ifstream stream(file, std::ios::binary);
+            inputs.emplace_back(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+
+            if(names != nullptr)
+                names->push_back(file.string());
+        }
+
+        return inputs;
+    }
+
+    // named by content, saving an input twice writes the same file.
+    inline std::string save_input(const std::filesystem::path& directory, const std::string_view prefix,
+                                  const std::vector<std::uint8_t>& input) {
+        char hash[17];
+        const auto end = std::to_chars(hash, hash + 16, gech::fnv1a(input.data(), input.size()), 16).ptr;
+
+        std::error_code error;
+        std::filesystem::create_directories(directory, error);
+
+        auto path = (directory / (std::string(prefix) + std::string(hash, end))).string();
+        std::ofstream(path, std::ios::binary | std::ios::trunc).write(reinterpret_cast<const char*>(input.data()),
+                                                                      static_cast<std::streamsize>(input.size()));
+        return path;
+    }
+
+    // one to four of: flip a bit, set, insert or erase bytes, write an
+    // interesting value, nudge a byte, copy a chunk over, splice in a chunk
+    // of another corpus input.
+    inline void mutate(std::vector<std::uint8_t>& input, gech::rng& rng,
+                       const std::vector<std::vector<std::uint8_t>>& corpus, const std::size_t max_len) {
+        static constexpr std::uint8_t interesting[] { 0, 1, 0x7f, 0x80, 0xff, 16, 32, 64, 100 };
+
+        for(auto count = 1 + rng.upto(3); count != 0; --count) {
+            const auto size = input.size();
+            const auto at = size == 0 ? 0 : rng.upto(size - 1);
+
+            switch(rng.upto(7)) {
+                case 0:
+                    if(size != 0)
+                        input[at] ^= static_cast<std::uint8_t>(1u << rng.upto(7));
+                    break;
+                case 1:
+                    if(size != 0)
+                        input[at] = static_cast<std::uint8_t>(rng.next());
+                    break;
+                case 2:
+                    if(size < max_len)
+                        input.insert(input.begin() + static_cast<std::ptrdiff_t>(rng.upto(size)),
+                                     static_cast<std::uint8_t>(rng.next()));
+                    break;
+                case 3:
+                    if(size != 0) {
+                        const auto length = 1 + rng.upto(std::min<std::size_t>(size - at, 8) - 1);
+                        input.erase(input.begin() + static_cast<std::ptrdiff_t>(at),
+                                    input.begin() + static_cast<std::ptrdiff_t>(at + length));
+                    }
+                    break;
+                case 4:
+                    if(size != 0) {
+                        const auto value = interesting[rng.upto(std::size(interesting) - 1)];
+                        const auto width = std::min<std::size_t>(size - at, std::size_t(1) << rng.upto(2));
+                        std::fill_n(input.begin() + static_cast<std::ptrdiff_t>(at), width, value);
+                    }
+                    break;
+                case 5:
+                    if(size != 0) {
+                        const auto delta = static_cast<std::uint8_t>(1 + rng.upto(15));
+                        input[at] = static_cast<std::uint8_t>(rng.next() & 1 ? input[at] + delta : input[at] - delta);
+                    }
+                    break;
+                case 6:
+                    if(size > 1) {
+                        const auto from = rng.upto(size - 1);
+                        const auto length = 1 + rng.upto(std::min(size - from, size - at) - 1);
+                        std::copy_n(input.begin() + static_cast<std::ptrdiff_t>(from), length,
+                                    input.begin() + static_cast<std::ptrdiff_t>(at));
+                    }
+                    break;
+                default: {
+                    const auto& other = corpus[rng.upto(corpus.size() - 1)];
+
+                    if(other.empty() || size >= max_len)
+                        break;
+
+                    const auto from = rng.upto(other.size() - 1);
+                    const auto length = 1 + rng.upto(std::min(other.size() - from, max_len - size) - 1);
+                    input.insert(input.begin() + static_cast<std::ptrdiff_t>(rng.upto(size)),
+                                 other.begin() + static_cast<std::ptrdiff_t>(from),
+                                 other.begin() + static_cast<std::ptrdiff_t>(from + length));
+                    break;
+                }
+            }
+        }
+    }
+
+    #ifdef GECHTEST_HAS_POSIX
+        // the input running when a fuzz target crashes for real goes to path
+        // before the signal takes the process down (or --isolate reports it).
+        class fuzz_crash {
+        public:
+            volatile sig_atomic_t armed = 0;
+
+            const std::uint8_t* data = nullptr;
+            std::size_t size = 0;
+            char path[4096] {};
+        public:
+            fuzz_crash() = default; ~fuzz_crash() = default;
+        };
+
+        inline fuzz_crash crashing;
+
+        inline void on_crash(int signal) {
+            if(gech::crashing.armed) {
+                const auto file = ::open(gech::crashing.path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+                if(file >= 0) {
+                    if(gech::crashing.size != 0 && ::write(file, gech::crashing.data, gech::crashing.size) < 0) {}
+                    ::close(file);
+                }
+            }
+
+            gech::on_fatal(signal);
+        }
+    #endif
+
+    // the context ASSERT_* macros write into; test_reg unless the calling
+    // thread is a runner worker.
+    inline thread_local test* current_test = nullptr;
+
+    // threads the test body starts have no current_test, they report into
+    // the test a gech::thread was started from, or else into default_owner:
+    // the one running cases in a serial run or isolated worker, the runner
+    // itself with -j.
+    inline thread_local test* thread_owner = nullptr;
+    inline test* default_owner = nullptr;
+
+    // what such a thread counted and logged, handed to its test in one piece.
+    class thread_result {
+    public:
+        unsigned errors = 0, passes = 0;
+        int rc = 0;
+
+        std::vector<record> records;
+
+        thread_result* next = nullptr;
+    public:
+        thread_result() = default; ~thread_result() = default;
+    };
+
+    class event_loop;
+
+    // loop whose run() is on this thread's stack, what awaitables reschedule on.
+    inline thread_local event_loop* running_loop = nullptr;
+
+    // single-threaded executor of CO_TEST() bodies. whatever a case awaits
+    // puts its handle back here, and resuming it points ASSERT_* (and the
+    // allocation tracker) at that case's test.
+    class event_loop {
+    public:
+        class entry {
+        public:
+            std::coroutine_handle<> handle;
+            gech::co_case* owner = nullptr;
+        };
+
+        class timer {
+        public:
+            std::chrono::steady_clock::time_point when;
+            std::uint64_t order = 0;
+            entry what;
+
+            // earliest first, same time in the order they were set.
+            bool operator>(const timer& other) const noexcept {
+                return this->when != other.when ? this->when > other.when : this->order > other.order;
+            }
+        };
+
+        std::deque<entry> ready;
+        std::priority_queue<timer, std::vector<timer>, std::greater<>> timers;
+        std::uint64_t timers_set = 0;
+
+        // resumed from other threads (gech::event::set()), taken in by run().
+        std::mutex lock;
+        std::condition_variable wake;
+        std::vector<entry> posted;
+
+        // case of the coroutine being resumed.
+        gech::co_case* current = nullptr;
+    public:
+        event_loop() = default; ~event_loop() = default;
+
+        // queueing is the loop's bookkeeping, not the running case's allocation.
+        void schedule(const std::coroutine_handle<> handle) {
+            gech::alloc_pause pause;
+            this->ready.push_back({ handle, this->current });
+        }
+
+        void schedule_at(const std::chrono::steady_clock::time_point when, const std::coroutine_handle<> handle) {
+            gech::alloc_pause pause;
+            this->timers.push({ when, this->timers_set++, { handle, this->current } });
+        }
+
+        void post(const entry& what) {
+            gech::alloc_pause pause;
+
+            {
+                std::lock_guard guard(this->lock);
+                this->posted.push_back(what);
+            }
+
+            this->wake.notify_one();
+        }
+
+        void spawn(gech::co_case& state, gech::task<>& body, const std::uint64_t timeout_ms) {
+            state.started = gech::clock::now();
+
+            if(timeout_ms != 0)
+                state.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeout_ms);
+
+            body.handle.promise().owner = &state;
+
+            gech::alloc_pause pause;
+            this->ready.push_back({ body.handle, &state });
+        }
+
+        void resume(const entry& next) {
+            const auto context = gech::current_test;
+            const auto current = this->current;
+
+            this->current = next.owner;
+            gech::current_test = next.owner->context;
+
+            #ifdef TEST_TRACK_ALLOC
+                const auto scope = gech::alloc_current;
+                gech::alloc_current = next.owner->scope;
+            #endif
+
+            next.handle.resume();
+
+            #ifdef TEST_TRACK_ALLOC
+                gech::alloc_current = scope;
+            #endif
+
+            gech::current_test = context;
+            this->current = current;
+        }
+
+        // until every case finished or ran past its deadline. deadlines are
+        // checked between resumes, a case blocking the thread is not cut off.
+        void run(gech::co_case* cases, const std::size_t count) {
+            const auto previous = gech::running_loop;
+            gech::running_loop = this;
+
+            while(true) {
+                {
+                    std::lock_guard guard(this->lock);
+                    this->ready.insert(this->ready.end(), this->posted.begin(), this->posted.end());
+                    this->posted.clear();
+                }
+
+                const auto now = std::chrono::steady_clock::now();
+
+                while(!this->timers.empty() && this->timers.top().when <= now) {
+                    this->ready.push_back(this->timers.top().what);
+                    this->timers.pop();
+                }
+
+                auto next = std::chrono::steady_clock::time_point::max();
+                bool pending = false;
+
+                for(std::size_t i = 0; i < count; ++i) {
+                    auto& state = cases[i];
+
+                    if(state.finished)
+                        continue;
+
+                    if(state.deadline <= now) {
+                        state.finished = state.timed_out = true;
+                        state.ended = gech::clock::now();
+                        continue;
+                    }
+
+                    pending = true;
+                    next = std::min(next, state.deadline);
+                }
+
+                if(!pending)
+                    break;
+
+                // only what is ready now, so timers and deadlines are not
+                // starved by cases that keep yielding.
+                if(!this->ready.empty()) {
+                    for(auto left = this->ready.size(); left != 0; --left) {
+                        const auto entry = this->ready.front();
+                        this->ready.pop_front();
+
+                        if(!entry.owner->finished)
+                            this->resume(entry);
+                    }
+
+                    continue;
+                }
+
+                if(!this->timers.empty())
+                    next = std::min(next, this->timers.top().when);
+
+                std::unique_lock guard(this->lock);
+                const auto posted = [this] { return !this->posted.empty(); };
+
+                if(next == std::chrono::steady_clock::time_point::max())
+                    this->wake.wait(guard, posted);
+                else
+                    this->wake.wait_until(guard, next, posted);
+            }
+
+            gech::running_loop = previous;
+        }
+    };
+
+    // co_await gech::sleep_for(10ms) suspends the case, the loop runs the
+    // other cases meanwhile.
+    class sleep_awaiter {
+    public:
+        std::chrono::steady_clock::time_point when;
+    public:
+        bool await_ready() const noexcept {
+            return this->when <= std::chrono::steady_clock::now();
+        }
+
+        void await_suspend(const std::coroutine_handle<> handle) const {
+            gech::running_loop->schedule_at(this->when, handle);
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    inline sleep_awaiter sleep_for(const std::chrono::steady_clock::duration duration) {
+        return { std::chrono::steady_clock::now() + duration };
+    }
+
+    // co_await gech::yield() lets every other ready case run once.
+    class yield_awaiter {
+    public:
+        bool await_ready() const noexcept { return false; }
+
+        void await_suspend(const std::coroutine_handle<> handle) const {
+            gech::running_loop->schedule(handle);
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    inline yield_awaiter yield() noexcept {
+        return {};
+    }
+
+    // co_await one to wait until it is set(), which any thread may do, e.g.
+    // a completion callback of the I/O under test. stays set until reset().
+    class event {
+    public:
+        class awaiter {
+        public:
+            gech::event* target;
+            gech::event_loop* loop = nullptr;
+            gech::event_loop::entry waiting;
+            awaiter *prev = nullptr, *next = nullptr;
+            bool linked = false;
+        public:
+            explicit awaiter(gech::event& target) noexcept : target(&target) {}
+            awaiter(const awaiter&) = delete;
+            awaiter& operator=(const awaiter&) = delete;
+
+            // a case that timed out is destroyed while still waiting.
+            ~awaiter() {
+                std::lock_guard guard(this->target->lock);
+
+                if(this->linked)
+                    this->target->unlink(this);
+            }
+
+            bool await_ready() const noexcept {
+                return this->target->signaled.load(std::memory_order_acquire);
+            }
+
+            bool await_suspend(const std::coroutine_handle<> handle) {
+                std::lock_guard guard(this->target->lock);
+
+                if(this->target->signaled.load(std::memory_order_relaxed))
+                    return false;
+
+                this->loop = gech::running_loop;
+                this->waiting = { handle, this->loop->current };
+                this->next = this->target->waiters;
+
+                if(this->next != nullptr)
+                    this->next->prev = this;
+
+                this->target->waiters = this;
+                this->linked = true;
+                return true;
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        std::mutex lock;
+        std::atomic<bool> signaled = false;
+        awaiter* waiters = nullptr;
+    public:
+        event() = default;
+        event(const event&) = delete;
+        event& operator=(const event&) = delete;
+        ~event() = default;
+
+        void set() {
+            std::lock_guard guard(this->lock);
+            this->signaled.store(true, std::memory_order_release);
+
+            while(this->waiters != nullptr) {
+                const auto waiter = this->waiters;
+                this->unlink(waiter);
+                waiter->loop->post(waiter->waiting);
+            }
+        }
+
+        void reset() noexcept {
+            this->signaled.store(false, std::memory_order_relaxed);
+        }
+
+        bool is_set() const noexcept {
+            return this->signaled.load(std::memory_order_acquire);
+        }
+
+        awaiter operator co_await() noexcept {
+            return awaiter(*this);
+        }
+    private:
+        void unlink(awaiter* waiter) noexcept {
+            if(waiter->prev != nullptr)
+                waiter->prev->next = waiter->next;
+            else
+                this->waiters = waiter->next;
+
+            if(waiter->next != nullptr)
+                waiter->next->prev = waiter->prev;
+
+            waiter->prev = waiter->next = nullptr;
+            waiter->linked = false;
+        }
+    };
+
+    class test {
+    public:
+        std::uint_least32_t line, column;
+
+        string file_name, function_name;
+
+        int rc = 0;
+
+        unsigned errors = 0, passes = 0;
+
+        // passing assertions are only counted, see pass().
+        bool quiet = false;
+
+        // cleared at the start of every case.
+        gech::log_arena<test_log_node> infos;
+        gech::log_arena<test_rc_node> rc_infos;
+
+        function_test func;
+
+        std::source_location current_location;
+
+        const gech::clock::time_point main_ms = gech::clock::now();
+
+        #ifdef TEST_GET_AS_STRING
+            gech::string_capture string_data;
+        #endif
+
+        // position of the running case, tags every record put() emits.
+        std::uint32_t case_index = gech::record::npos;
+
+        // name and registration site of the running case, see record::function.
+        string case_name;
+        std::source_location case_location;
+
+        // isolated workers collect records here instead of the writer thread.
+        std::vector<gech::record>* capture = nullptr;
+
+        // registry indices this process runs, after sharding.
+        std::vector<std::size_t> selected;
+        gech::timings timings;
+
+        unsigned shard_index = 0, total_shards = 1;
+
+        // summaries are formatted here once, then handed to the writer.
+        std::string report;
+
+        gech::bench_config bench;
+        std::vector<gech::bench_result> benches;
+
+        bool perf = false;
+        gech::perf_counters counters;
+        std::vector<gech::perf_result> perf_results;
+
+        // runs per case when a baseline is read or written, 0 otherwise.
+        unsigned baseline_samples = 0;
+        std::vector<gech::baseline_entry> baseline_results;
+        std::vector<std::string> regressions;
+        std::size_t baseline_compared = 0;
+
+        // --baseline read at the start of the run, each case is compared
+        // against it right after its samples.
+        const gech::baseline* baseline_before = nullptr;
+        double baseline_threshold = 10;
+
+        // set on a thread_context's test, the test it reports into.
+        test* owner = nullptr;
+
+        // bumped per body run, so a pooled thread notices the case changed.
+        std::uint64_t runs = 0;
+
+        // pushed by threads as they finish, taken over by collect_threads().
+        std::atomic<gech::thread_result*> thread_results = nullptr;
+
+        unsigned property_runs = 1000;
+        std::uint64_t seed = 0;
+
+        // while a PROPERTY() probes an input, assertions only count failures
+        // in falsified: no records, no text, no pass counting.
+        bool probing = false;
+        unsigned falsified = 0;
+
+        gech::fuzz_config fuzz;
+
+        std::uint64_t co_timeout_ms = 10000;
+    public:
+        test() {
+            this->fill_infos();
+        }
+
+        ~test() = default;
+
+        auto since_time() {
+            return std::chrono::nanoseconds(gech::elapsed_ns(this->main_ms));
+        }
+
+        void summary() {
+            // a forked worker has no writer thread and the parent prints the summary.
+            if(this->capture != nullptr)
+                return;
+
+            gech::writer().flush();
+            this->report.clear();
+
+            if(!this->benches.empty())
+                this->bench_summary();
+
+            if(!this->perf_results.empty())
+                this->perf_summary();
+
+            if(this->baseline_compared != 0)
+                this->baseline_summary();
+
+            const auto ns = static_cast<std::uint64_t>(since_time().count());
+
+            this->report += "\n[SUMMARY]\nFile: ";
+            this->report += this->current_location.file_name();
+            this->report += "\nError/s: ";
+            gech::append_number(this->report, this->errors);
+            this->report += "\nPass/es: ";
+            gech::append_number(this->report, this->passes);
+            this->report += '\n';
+
+            if(this->total_shards > 1) {
+                this->report += "Shard: ";
+                gech::append_number(this->report, this->shard_index + 1);
+                this->report += '/';
+                gech::append_number(this->report, this->total_shards);
+                this->report += '\n';
+            }
+
+            gech::append_number(this->report, ns);
+            this->report += "ns\n";
+
+            gech::writer().print(this->report);
+            gech::writer().end(this->errors, this->passes, ns);
+        }
+
+        void bench_summary() {
+            this->report += "\n[BENCH]\n";
+
+            for(const auto& bench : this->benches) {
+                this->report += bench.name;
+                this->report += " -> min: ";
+                gech::append_number(this->report, bench.min);
+                this->report += "ns, median: ";
+                gech::append_number(this->report, bench.median);
+                this->report += "ns, p99: ";
+                gech::append_number(this->report, bench.p99);
+                this->report += "ns, stddev: ";
+                gech::append_number(this->report, bench.stddev);
+                // a count of iterations, not a rate.
+                this->report += "ns, iterations: ";
+                gech::append_number(this->report, bench.iterations);
+
+                if(!bench.counters.empty()) {
+                    this->report += ", ";
+                    bench.counters.print(this->report);
+                }
+
+                if(bench.exhausted) {
+                    this->report += ", budget exhausted after ";
+                    gech::append_number(this->report, bench.samples);
+                    this->report += " sample/s";
+                }
+
+                this->report += '\n';
+            }
+        }
+
+        void perf_summary() {
+            this->report += "\n[PERF]\n";
+
+            for(const auto& result : this->perf_results) {
+                this->report += result.name;
+                this->report += " -> ";
+                result.counters.print(this->report);
+                this->report += '\n';
+            }
+        }
+
+        void baseline_summary() {
+            this->report += "\n[BASELINE]\n";
+
+            for(const auto& line : this->regressions) {
+                this->report += line;
+                this->report += '\n';
+            }
+
+            this->report += "Compared: ";
+            gech::append_number(this->report, this->baseline_compared);
+            this->report += "\nRegression/s: ";
+            gech::append_number(this->report, this->regressions.size());
+            this->report += '\n';
+        }
+
+        // the [BASELINE] summary; regressed cases already failed in check_regression().
+        void check_baseline() {
+            for(const auto& entry : this->baseline_results) {
+                const auto found = this->baseline_before->cases.find(entry.name);
+
+                if(found == this->baseline_before->cases.end())
+                    continue;
+
+                ++this->baseline_compared;
+
+                if(!gech::baseline::regressed(found->second, entry.stats, this->baseline_threshold))
+                    continue;
+
+                std::string line = "[REGRESSION]: ";
+                line += entry.name;
+                line += " -> ";
+                gech::append_number(line, std::llround(entry.stats.mean));
+                line += "ns, baseline ";
+                gech::append_number(line, std::llround(found->second.mean));
+                line += "ns (+";
+                gech::append_number(line, std::llround((entry.stats.mean / found->second.mean - 1) * 100));
+                line += "%)";
+
+                this->regressions.push_back(std::move(line));
+            }
+        }
+
+        // fails the running case when its samples are slower than the baseline's.
+        void check_regression(const gech::baseline_entry& entry, const std::source_location location) {
+            const auto found = this->baseline_before->cases.find(entry.name);
+
+            if(found == this->baseline_before->cases.end()
+            || !gech::baseline::regressed(found->second, entry.stats, this->baseline_threshold))
+                return;
+
+            std::string text = "Slower than baseline, expected at most +";
+            gech::append_number(text, std::llround(this->baseline_threshold));
+            text += "%: ";
+            gech::append_number(text, std::llround(entry.stats.mean));
+            text += "ns, baseline ";
+            gech::append_number(text, std::llround(found->second.mean));
+            text += "ns (+";
+            gech::append_number(text, std::llround((entry.stats.mean / found->second.mean - 1) * 100));
+            text += "%)";
+
+            this->current_location = location;
+            this->fail(Error, this->keep(std::move(text)), true);
+        }
+
+        // reruns a case for another timing sample, with everything it would
+        // log or count thrown away; the first run already reported it.
+        std::uint64_t resample(const gech::test_case& test) {
+            const auto errors = this->errors;
+            const auto passes = this->passes;
+            const auto rc = this->rc;
+            const auto benches = this->benches.size();
+            const auto quiet = this->quiet;
+            const auto capture = this->capture;
+            std::vector<gech::record> discarded;
+
+            this->quiet = true;
+            this->capture = &discarded;
+            this->infos.clear();
+
+            const auto ms_took = this->calculate_time(test.func);
+
+            this->errors = errors;
+            this->passes = passes;
+            this->rc = rc;
+            this->benches.resize(benches);
+            this->quiet = quiet;
+            this->capture = capture;
+
+            for(const auto& entry : discarded)
+                gech::writer().release(entry);
+
+            return ms_took;
+        }
+
+        std::uint64_t calculate_time(function_test func) {
+            ++this->runs;
+
+            const auto ms = gech::clock::now();
+            func();
+            const auto ms_took = gech::elapsed_ns(ms);
+
+            this->collect_threads();
+            return ms_took;
+        }
+
+        // counts and records of threads that finished, oldest first, as if
+        // this test had asserted them; their errors are already counted.
+        void collect_threads() {
+            gech::alloc_pause pause;
+            auto result = this->thread_results.exchange(nullptr, std::memory_order_acquire);
+            gech::thread_result* ordered = nullptr;
+
+            while(result != nullptr) {
+                const auto next = result->next;
+                result->next = ordered;
+                ordered = result;
+                result = next;
+            }
+
+            while(ordered != nullptr) {
+                this->errors += ordered->errors;
+                this->passes += ordered->passes;
+                this->rc += ordered->rc;
+
+                for(const auto& entry : ordered->records)
+                    this->emit(entry);
+
+                const auto next = ordered->next;
+                delete ordered;
+                ordered = next;
+            }
+        }
+
+        // lock-free push, the only point a thread under test touches its test.
+        void adopt(gech::thread_result* result) noexcept {
+            result->next = this->thread_results.load(std::memory_order_relaxed);
+
+            while(!this->thread_results.compare_exchange_weak(result->next, result,
+                                                              std::memory_order_release,
+                                                              std::memory_order_relaxed));
+        }
+
+        // runs body on property_runs generated inputs. assertions only probe
+        // meanwhile, so a passing run logs and allocates nothing; the first
+        // input that fails one is shrunk (see gen) while it keeps failing,
+        // then reported and run once more for real, so its assertions print
+        // as usual. inputs follow from the seed and the name, --seed replays them.
+        template <typename... Gens>
+        void run_property(const string name, void (*body)(const std::tuple<typename Gens::value_type...>&),
+                          const std::tuple<Gens...>& gens,
+                          const std::source_location location = std::source_location::current()) {
+            using values_type = std::tuple<typename Gens::value_type...>;
+            constexpr auto indices = std::index_sequence_for<Gens...>();
+
+            // fnv-1a, each property draws its own inputs wherever it is scheduled.
+            std::uint64_t hash = 0xcbf29ce484222325;
+
+            for(const auto c : name)
+                hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001b3;
+
+            gech::rng rng(this->seed ^ hash);
+            values_type values;
+
+            const auto falsifies = [this, body](const values_type& input) {
+                this->falsified = 0;
+                this->probing = true;
+                body(input);
+                this->probing = false;
+                return this->falsified != 0;
+            };
+
+            unsigned run = 0;
+
+            for(; run < this->property_runs; ++run) {
+                [&]<std::size_t... Index>(std::index_sequence<Index...>) {
+                    (std::get<Index>(gens).generate(std::get<Index>(values), rng, run), ...);
+                }(indices);
+
+                if(falsifies(values)) [[unlikely]]
+                    break;
+            }
+
+            this->current_location = location;
+
+            if(run == this->property_runs) {
+                this->pass();
+                return;
+            }
+
+            // the first argument with a simpler failing value wins, then start over.
+            unsigned shrinks = 0;
+
+            const auto shrink = [&]<std::size_t Index>(std::integral_constant<std::size_t, Index>) {
+                for(auto&& candidate : std::get<Index>(gens).shrinks(std::get<Index>(values))) {
+                    auto trial = values;
+                    std::get<Index>(trial) = std::move(candidate);
+
+                    if(falsifies(trial)) {
+                        values = std::move(trial);
+                        return true;
+                    }
+                }
+
+                return false;
+            };
+
+            while(shrinks < gech::max_shrinks && [&]<std::size_t... Index>(std::index_sequence<Index...>) {
+                return (shrink(std::integral_constant<std::size_t, Index>()) || ...);
+            }(indices))
+                ++shrinks;
+
+            std::string text("Property falsified after ");
+            gech::append_number(text, run + 1);
+            text += " run/s and ";
+            gech::append_number(text, shrinks);
+            text += " shrink/s (--seed ";
+            gech::append_number(text, this->seed);
+            text += "): ";
+            gech::print_value(text, values);
+
+            this->current_location = location;
+            this->fail(Error, this->keep(std::move(text)), true);
+            body(values);
+        }
+
+        // FUZZ_TEST(). without --fuzz the empty input and every corpus input
+        // are probed like PROPERTY() inputs, failing ones are reported and
+        // run again for real. with it, inputs mutated from the corpus run
+        // with coverage traced; those reaching new coverage join the corpus,
+        // the first one failing an assertion or assert_rc() counts as a
+        // crash, is minimized, saved as crash-<hash> and reported likewise.
+        void run_fuzz(const string name, void (*body)(const std::uint8_t*, std::size_t),
+                      const std::source_location location = std::source_location::current()) {
+            const auto directory = this->fuzz.corpus.empty()
+                                   ? std::filesystem::path()
+                                   : std::filesystem::path(this->fuzz.corpus) / std::string(name);
+
+            std::vector<std::string> names { "(empty input)" };
+            std::vector<std::vector<std::uint8_t>> corpus(1);
+
+            for(auto& input : gech::load_corpus(directory, &names))
+                corpus.push_back(std::move(input));
+
+            const auto crashes = [this, body](const std::vector<std::uint8_t>& input) {
+                const auto rc = this->rc;
+                this->falsified = 0;
+                this->probing = true;
+
+                #ifdef GECHTEST_HAS_ASAN
+                    std::unique_ptr<std::uint8_t[]> exact(new std::uint8_t[input.size()]);
+                    std::copy(input.begin(), input.end(), exact.get());
+                    const auto data = exact.get();
+                #else
+                    const auto data = input.data();
+                #endif
+
+                #ifdef GECHTEST_HAS_POSIX
+                    gech::crashing.data = data;
+                    gech::crashing.size = input.size();
+                #endif
+
+                body(data, input.size());
+
+                this->probing = false;
+                this->rc = rc;
+                return this->falsified != 0;
+            };
+
+            this->current_location = location;
+
+            if(!this->fuzz.enabled) {
+                bool failed = false;
+
+                for(std::size_t i = 0; i < corpus.size(); ++i) {
+                    if(!crashes(corpus[i]))
+                        continue;
+
+                    failed = true;
+                    this->current_location = location;
+                    this->fail(Error, this->keep("Fuzz input crashed: " + names[i]), true);
+                    body(corpus[i].data(), corpus[i].size());
+                }
+
+                if(!failed) {
+                    this->current_location = location;
+                    this->pass();
+                }
+
+                return;
+            }
+
+            std::lock_guard<std::mutex> guard(gech::fuzz_lock());
+
+            gech::rng rng(this->seed ^ gech::fnv1a(name.data(), name.size()));
+            std::vector<std::uint8_t> seen(gech::coverage_map::size), input, crash;
+            std::size_t edges = 0;
+            std::uint64_t runs = 0;
+            bool novel = false, found = false;
+
+            input.reserve(this->fuzz.max_len);
+
+            const auto execute = [&](const std::vector<std::uint8_t>& input) {
+                gech::coverage_tracing = true;
+                const auto crashed = crashes(input);
+                gech::coverage_tracing = false;
+
+                novel = gech::coverage.take(seen, edges);
+                ++runs;
+                return crashed;
+            };
+
+            #ifdef GECHTEST_HAS_POSIX
+                if(!directory.empty()) {
+                    std::error_code error;
+                    std::filesystem::create_directories(directory, error);
+                }
+
+                const auto path = (directory / ("crash-" + std::string(name))).string();
+                std::snprintf(gech::crashing.path, sizeof(gech::crashing.path), "%s", path.c_str());
+
+                const int signals[] { SIGSEGV, SIGBUS, SIGFPE, SIGILL, SIGABRT };
+                struct sigaction action {}, previous[std::size(signals)];
+                action.sa_handler = gech::on_crash;
+
+                for(std::size_t i = 0; i < std::size(signals); ++i)
+                    ::sigaction(signals[i], &action, &previous[i]);
+
+                gech::crashing.armed = 1;
+            #endif
+
+            const auto started = gech::clock::now();
+
+            // the corpus first, for the coverage it already reaches.
+            for(const auto& entry : corpus) {
+                if(execute(entry)) {
+                    crash = entry;
+                    found = true;
+                    break;
+                }
+            }
+
+            while(!found && (this->fuzz.runs == 0 || runs < this->fuzz.runs)) {
+                if((runs & 1023) == 0 && gech::elapsed_ns(started) >= this->fuzz.max_ns)
+                    break;
+
+                input = corpus[rng.upto(corpus.size() - 1)];
+                gech::mutate(input, rng, corpus, this->fuzz.max_len);
+
+                if(execute(input)) [[unlikely]] {
+                    crash = input;
+                    found = true;
+                }
+                else if(novel) {
+                    corpus.push_back(input);
+
+                    if(!directory.empty())
+                        gech::save_input(directory, "", input);
+                }
+            }
+
+            const auto ns = std::max<std::uint64_t>(gech::elapsed_ns(started), 1);
+
+            #ifdef GECHTEST_HAS_POSIX
+                gech::crashing.armed = 0;
+
+                for(std::size_t i = 0; i < std::size(signals); ++i)
+                    ::sigaction(signals[i], &previous[i], nullptr);
+            #endif
+
+            this->current_location = location;
+
+            if(!found) {
+                ++this->passes;
+
+                if(this->quiet_pass())
+                    return;
+
+                std::string text("Fuzzed ");
+                gech::append_number(text, runs);
+                text += " run/s at ";
+                gech::append_number(text, runs * 1'000'000'000 / ns);
+                text += " exec/s, corpus: ";
+                gech::append_number(text, corpus.size());
+                text += " input/s, coverage: ";
+                gech::append_number(text, edges);
+                text += " edge/s";
+                this->put_record(Success, this->keep(std::move(text)), 0, true);
+                return;
+            }
+
+            // drop halves, quarters, ... single bytes, then zero bytes, while
+            // it still crashes; within a fixed number of tries.
+            const auto original = crash.size();
+            std::vector<std::uint8_t> trial;
+            std::size_t tries = 1 << 16;
+
+            for(bool smaller = true; smaller && tries != 0;) {
+                smaller = false;
+
+                for(auto chunk = crash.size(); chunk != 0 && !smaller && tries != 0; chunk /= 2) {
+                    for(std::size_t at = 0; at + chunk <= crash.size() && !smaller && tries != 0; at += chunk, --tries) {
+                        trial.assign(crash.begin(), crash.begin() + static_cast<std::ptrdiff_t>(at));
+                        trial.insert(trial.end(), crash.begin() + static_cast<std::ptrdiff_t>(at + chunk), crash.end());
+
+                        if(crashes(trial)) {
+                            crash.swap(trial);
+                            smaller = true;
+                        }
+                    }
+                }
+
+                for(std::size_t at = 0; at < crash.size() && !smaller && tries != 0; ++at) {
+                    if(crash[at] == 0)
+                        continue;
+
+                    trial = crash;
+                    trial[at] = 0;
+                    --tries;
+
+                    if(crashes(trial)) {
+                        crash.swap(trial);
+                        smaller = true;
+                    }
+                }
+            }
+
+            const auto saved = directory.empty()
+                               ? gech::save_input(std::filesystem::current_path(), "crash-" + std::string(name) + '-', crash)
+                               : gech::save_input(directory, "crash-", crash);
+
+            std::string text("Fuzz input crashed after ");
+            gech::append_number(text, runs);
+            text += " run/s, minimized from ";
+            gech::append_number(text, original);
+            text += " to ";
+            gech::append_number(text, crash.size());
+            text += " byte/s, saved as ";
+            text += saved;
+
+            if(!crash.empty())
+                text += ':';
+
+            for(std::size_t i = 0; i < crash.size() && i < 64; ++i) {
+                static constexpr char digits[] = "0123456789abcdef";
+                text += ' ';
+                text += digits[crash[i] >> 4];
+                text += digits[crash[i] & 15];
+            }
+
+            if(crash.size() > 64)
+                text += " ...";
+
+            this->current_location = location;
+            this->fail(Error, this->keep(std::move(text)), true);
+            body(crash.data(), crash.size());
+        }
+
+        // runs body in batches until the mean per-iteration time settles
+        // (or bench.max_ns runs out), then keeps the distribution's summary.
+        void run_bench(const string name, function_test body, const std::uint64_t warmup,
+                       const std::source_location location = std::source_location::current()) {
+            const auto elapsed = gech::elapsed_ns;
+            const auto started = clock::now();
+
+            for(std::uint64_t i = 0; i < warmup; ++i)
+                body();
+
+            // batch enough iterations into one sample to stay well above clock resolution.
+            auto at = clock::now();
+            body();
+            const auto batch = std::max<std::uint64_t>(10'000 / std::max<std::uint64_t>(elapsed(at), 1), 1);
+
+            std::vector<double> samples;
+            double sum = 0, square = 0;
+            bool exhausted = false;
+
+            samples.reserve(this->bench.max_samples);
+
+            // run_case() already has the counters running for the whole case.
+            const auto counted = this->perf ? this->counters.read() : gech::perf_sample();
+
+            while(samples.size() < this->bench.max_samples) {
+                at = clock::now();
+
+                for(std::uint64_t i = 0; i < batch; ++i)
+                    body();
+
+                const double sample = static_cast<double>(elapsed(at)) / batch;
+                samples.push_back(sample);
+                sum += sample;
+                square += sample * sample;
+
+                const auto count = samples.size();
+
+                // the budget holds for slow bodies too, settled or not.
+                if(elapsed(started) >= this->bench.max_ns) {
+                    exhausted = count < this->bench.min_samples;
+                    break;
+                }
+
+                if(count < this->bench.min_samples)
+                    continue;
+
+                const double mean = sum / count;
+                const double variance = std::max((square - sum * mean) / (count - 1), 0.0);
+
+                if(std::sqrt(variance / count) <= this->bench.stable_error * mean)
+                    break;
+            }
+
+            const auto counted_end = this->perf ? this->counters.read() : gech::perf_sample();
+
+            std::sort(samples.begin(), samples.end());
+
+            const auto count = samples.size();
+            const double mean = sum / count;
+            const double variance = count > 1 ? std::max((square - sum * mean) / (count - 1), 0.0) : 0.0;
+            const auto p99 = static_cast<std::size_t>(std::ceil(0.99 * count)) - 1;
+
+            gech::bench_result result;
+            result.name = name;
+            result.iterations = batch * count;
+            result.samples = count;
+            result.min = std::llround(samples.front());
+            result.median = std::llround(count % 2 != 0 ? samples[count / 2]
+                                                         : (samples[count / 2 - 1] + samples[count / 2]) / 2);
+            result.p99 = std::llround(samples[p99]);
+            result.mean = std::llround(mean);
+            result.stddev = std::llround(std::sqrt(variance));
+            result.counters = gech::perf_sample::delta(counted, counted_end, result.iterations);
+            result.exhausted = exhausted;
+            result.location = location;
+            // results outlive the case, they are not its leak.
+            gech::alloc_pause pause;
+            this->benches.push_back(result);
+        }
+
+        int run_tests(const gech::options& opts = gech::options()) {
+            #ifdef GECHTEST_HAS_FORK
+                if(opts.shards > 1 && opts.total_shards == 1)
+                    return this->launch_shards(opts);
+            #endif
+
+            const auto& cases = gech::registry();
+
+            if(!opts.timings.empty())
+                this->timings.load(opts.timings);
+
+            this->quiet = opts.quiet;
+            this->bench = opts.bench;
+            this->perf = opts.perf;
+            this->baseline_samples = opts.baseline.empty() && opts.baseline_write.empty() ? 0 : opts.baseline_samples;
+            this->infos.cap = this->rc_infos.cap = opts.arena_cap;
+            this->property_runs = opts.property_runs;
+            this->seed = opts.seed;
+            this->fuzz = opts.fuzz;
+            this->co_timeout_ms = opts.co_timeout_ms;
+            this->shard_index = opts.shard_index;
+            this->total_shards = opts.total_shards;
+            this->selected = this->timings.shard(cases, opts.shard_index, opts.total_shards);
+            this->baseline_threshold = opts.baseline_threshold;
+
+            gech::baseline before;
+
+            if(!opts.baseline.empty()) {
+                before.load(opts.baseline);
+                this->baseline_before = &before;
+            }
+
+            if(!opts.reporters.empty())
+                this->use_reporters(opts);
+
+            gech::writer().begin(this->selected.size());
+            gech::watch_crashes();
+
+            gech::current_test = this;
+            gech::default_owner = this;
+
+            if(opts.isolate)
+                this->run_isolated(opts.jobs);
+            else if(opts.jobs > 1 && this->selected.size() > 1)
+                this->run_parallel(opts.jobs);
+            else {
+                for(std::size_t i = 0; i < this->selected.size();) {
+                    if(cases[this->selected[i]].co_func == nullptr) {
+                        this->timings.record(cases[this->selected[i]].name, this->run_case(cases[this->selected[i]], i));
+                        gech::writer().sync();
+                        ++i;
+                        continue;
+                    }
+
+                    // consecutive CO_TEST()s share one loop.
+                    auto last = i + 1;
+
+                    while(last < this->selected.size() && cases[this->selected[last]].co_func != nullptr)
+                        ++last;
+
+                    this->run_coroutines(i, last);
+                    i = last;
+                }
+            }
+
+            // threads started without gech::thread under -j land here.
+            this->case_index = gech::record::npos;
+            this->case_name = string();
+            this->case_location = std::source_location();
+            this->collect_threads();
+
+            gech::current_test = nullptr;
+            gech::default_owner = nullptr;
+
+            this->assert_rc();
+
+            if(this->baseline_before != nullptr)
+                this->check_baseline();
+
+            this->baseline_before = nullptr;
+
+            this->summary();
+
+            if(!opts.baseline_write.empty()) {
+                gech::baseline after;
+                after.load(opts.baseline_write);
+
+                for(const auto& entry : this->baseline_results)
+                    after.record(entry);
+
+                after.save(opts.total_shards > 1
+                           ? opts.baseline_write + '.' + std::to_string(opts.shard_index)
+                           : opts.baseline_write);
+            }
+
+            // shards write their own file, the launcher (or CI) merges them.
+            if(!opts.timings.empty())
+                this->timings.save(opts.total_shards > 1
+                                   ? opts.timings + '.' + std::to_string(opts.shard_index)
+                                   : opts.timings);
+
+            return this->errors != 0 ? 1 : 0;
+        }
+
+        void use_reporters(const gech::options& opts) {
+            std::vector<std::unique_ptr<gech::report_sink>> sinks;
+
+            for(const auto& reporter : opts.reporters) {
+                const auto colon = reporter.find(':');
+                auto sink = std::make_unique<gech::report_sink>();
+                sink->format = gech::make_reporter(string(reporter).substr(0, colon));
+
+                if(colon == std::string::npos)
+                    sink->open(stdout);
+                else {
+                    // shards write their own file, like timings.
+                    const auto path = reporter.substr(colon + 1) + (opts.total_shards > 1
+                                      ? '.' + std::to_string(opts.shard_index) : std::string());
+                    const auto file = std::fopen(path.c_str(), "w");
+
+                    if(file == nullptr) {
+                        std::perror(("gechtest: " + path).c_str());
+                        std::exit(2);
+                    }
+
+                    sink->open(file);
+                }
+
+                sinks.push_back(std::move(sink));
+            }
+
+            gech::writer().use(std::move(sinks));
+        }
+
+        std::uint64_t run_case(const gech::test_case& test, std::size_t position) {
+            this->case_index = position;
+            this->case_name = test.name;
+            this->case_location = test.location;
+            this->infos.clear();
+            this->rc_infos.clear();
+            this->test_function(test.func);
+
+            if(this->perf)
+                this->counters.start();
+
+            #ifdef TEST_TRACK_ALLOC
+                gech::alloc_scope scope;
+                gech::alloc_current = &scope;
+            #endif
+
+            const auto ms_took = this->calculate_time(test.func);
+            const auto counted = this->perf ? this->counters.stop() : gech::perf_sample();
+
+            #ifdef TEST_TRACK_ALLOC
+                gech::alloc_current = nullptr;
+                this->check_leaks(scope, test.location);
+            #endif
+
+            this->end_case(test, position, ms_took, counted);
+            return ms_took;
+        }
+
+        // what every case ends with: its timing and counters, baseline
+        // samples and the end record.
+        void end_case(const gech::test_case& test, std::size_t position,
+                      std::uint64_t ms_took, const gech::perf_sample& counted) {
+            if(auto node = this->infos.find(0)) {
+                node->ms_took = ms_took;
+                node->counters = counted;
+            }
+
+            if(this->perf) {
+                gech::perf_result result;
+                result.name = test.name;
+                result.counters = counted;
+                this->perf_results.push_back(result);
+            }
+
+            if(this->baseline_samples != 0) {
+                gech::baseline_entry entry;
+                entry.name = test.name;
+                entry.stats.add(ms_took);
+
+                for(unsigned i = 1; i < this->baseline_samples; ++i)
+                    entry.stats.add(this->resample(test));
+
+                if(this->baseline_before != nullptr)
+                    this->check_regression(entry, test.location);
+
+                this->baseline_results.push_back(entry);
+            }
+
+            // reporters take the case name and run time from its end record.
+            gech::record end;
+            end.kind = CaseEnd;
+            end.case_index = position;
+            end.ms_took = ms_took;
+            end.data = test.name;
+            end.location = test.location;
+            this->emit(end);
+        }
+
+        // the CO_TEST()s at positions [first, last) run concurrently on one
+        // loop, each in a context of its own, then end in order as if run
+        // one after another; their time is from start to finish.
+        void run_coroutines(std::size_t first, std::size_t last) {
+            const auto& cases = gech::registry();
+            const auto count = last - first;
+
+            std::unique_ptr<gech::test[]> contexts(new gech::test[count]);
+            std::vector<gech::co_case> states(count);
+
+            #ifdef TEST_TRACK_ALLOC
+                std::unique_ptr<gech::alloc_scope[]> scopes(new gech::alloc_scope[count]);
+            #endif
+
+            // before the tasks, a timed out case's frame may still be queued.
+            gech::event_loop loop;
+            std::vector<gech::task<>> tasks;
+            tasks.reserve(count);
+
+            for(std::size_t i = 0; i < count; ++i) {
+                const auto& test = cases[this->selected[first + i]];
+                auto& context = contexts[i];
+
+                context.inherit(*this);
+                context.current_location = this->current_location;
+                // counters cannot tell interleaved cases apart.
+                context.perf = false;
+                context.case_index = first + i;
+                context.case_name = test.name;
+                context.case_location = test.location;
+                context.capture = this->capture;
+                context.test_function(test.func);
+                ++context.runs;
+
+                states[i].context = &context;
+
+                #ifdef TEST_TRACK_ALLOC
+                    states[i].scope = &scopes[i];
+                #endif
+
+                tasks.push_back(test.co_func());
+                loop.spawn(states[i], tasks.back(), test.timeout_ms != 0 ? test.timeout_ms : this->co_timeout_ms);
+            }
+
+            loop.run(states.data(), count);
+
+            for(std::size_t i = 0; i < count; ++i) {
+                const auto& test = cases[this->selected[first + i]];
+                auto& context = contexts[i];
+                auto& state = states[i];
+
+                // resamples drive the case through gech::context().
+                gech::current_test = &context;
+                context.collect_threads();
+
+                if(state.timed_out)
+                    context.timed_out(test.timeout_ms != 0 ? test.timeout_ms : this->co_timeout_ms, test.location);
+
+                if(state.error)
+                    context.threw(std::exchange(state.error, nullptr), test.location);
+
+                // destroys the frame, and a timed out case's locals with it.
+                tasks[i].reset();
+
+                #ifdef TEST_TRACK_ALLOC
+                    context.check_leaks(scopes[i], test.location);
+                #endif
+
+                const auto ms_took = static_cast<std::uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(state.ended - state.started).count());
+
+                context.end_case(test, first + i, ms_took, gech::perf_sample());
+                gech::current_test = this;
+
+                gech::case_result result;
+                context.take_result(result);
+                this->merge_result(result);
+                this->timings.record(test.name, ms_took);
+                gech::writer().sync();
+            }
+        }
+
+        // drives one CO_TEST() alone, how -j, --isolate and resamples run it.
+        void run_coroutine(gech::co_test body, const std::uint64_t timeout_ms,
+                           const std::source_location location = std::source_location::current()) {
+            const auto timeout = timeout_ms != 0 ? timeout_ms : this->co_timeout_ms;
+
+            gech::co_case state;
+            state.context = this;
+
+            #ifdef TEST_TRACK_ALLOC
+                state.scope = gech::alloc_current;
+            #endif
+
+            gech::event_loop loop;
+            auto task = body();
+            loop.spawn(state, task, timeout);
+            loop.run(&state, 1);
+
+            if(state.timed_out)
+                this->timed_out(timeout, location);
+
+            if(state.error)
+                this->threw(std::exchange(state.error, nullptr), location);
+        }
+
+        void timed_out(const std::uint64_t timeout_ms, const std::source_location location) {
+            // the kept text outlives the case, it is not its leak.
+            gech::alloc_pause pause;
+            std::string text = "Coroutine timed out, expected it to finish within ";
+            gech::append_number(text, timeout_ms);
+            text += "ms";
+
+            this->current_location = location;
+            this->fail(Error, this->keep(std::move(text)), true);
+        }
+
+        // an exception that left a CO_TEST() body fails that case alone,
+        // the cases interleaved with it carry on.
+        void threw(const std::exception_ptr error, const std::source_location location) {
+            gech::alloc_pause pause;
+            std::string text = "Coroutine threw, expected it to finish: ";
+
+            try {
+                std::rethrow_exception(error);
+            } catch(const std::exception& thrown) {
+                text += thrown.what();
+            } catch(...) {
+                text += "unknown exception";
+            }
+
+            this->current_location = location;
+            this->fail(Error, this->keep(std::move(text)), true);
+        }
+
+        #ifdef TEST_TRACK_ALLOC
+            // whatever the case left allocated fails it (the MemLeak check),
+            // listing the biggest allocation sites. the blocks stay allocated
+            // but are no longer tracked.
+            void check_leaks(gech::alloc_scope& scope, const std::source_location location) {
+                gech::alloc_pause pause;
+
+                class site {
+                public:
+                    void* address;
+                    std::size_t bytes, count;
+                };
+
+                std::vector<site> sites;
+
+                scope.acquire();
+
+                const auto bytes = scope.live_bytes, count = scope.live_count;
+
+                for(auto header = scope.head; header != nullptr; header = header->next) {
+                    header->scope = nullptr;
+
+                    const auto found = std::find_if(sites.begin(), sites.end(),
+                                                    [&](const site& entry) { return entry.address == header->site; });
+
+                    if(found == sites.end())
+                        sites.push_back({ header->site, header->size, 1 });
+                    else {
+                        found->bytes += header->size;
+                        ++found->count;
+                    }
+                }
+
+                scope.head = nullptr;
+                scope.release();
+
+                if(count == 0)
+                    return;
+
+                std::sort(sites.begin(), sites.end(), [](const site& a, const site& b) { return a.bytes > b.bytes; });
+
+                std::string text = "Memory leaked, expected every allocation freed: ";
+                gech::append_number(text, bytes);
+                text += " byte/s in ";
+                gech::append_number(text, count);
+                text += " block/s";
+
+                for(std::size_t i = 0; i < std::min<std::size_t>(sites.size(), 8); ++i) {
+                    text += i == 0 ? ", from " : ", ";
+                    gech::print_site(text, sites[i].address);
+                    text += " (";
+                    gech::append_number(text, sites[i].bytes);
+                    text += " byte/s in ";
+                    gech::append_number(text, sites[i].count);
+                    text += " block/s)";
+                }
+
+                if(sites.size() > 8) {
+                    text += ", +";
+                    gech::append_number(text, sites.size() - 8);
+                    text += " more site/s";
+                }
+
+                this->current_location = location;
+                this->fail(Error, this->keep(std::move(text)), true);
+            }
+        #endif
+
+        void emit(const gech::record& entry) {
+            // a thread's first record sets up its writer ring.
+            gech::alloc_pause pause;
+
+            if(this->capture != nullptr)
+                this->capture->push_back(entry);
+            else
+                gech::writer().push(entry);
+        }
+
+        void merge_results(std::vector<gech::case_result>& results) {
+            const auto& cases = gech::registry();
+
+            for(std::size_t i = 0; i < results.size(); ++i) {
+                this->merge_result(results[i]);
+                this->timings.record(cases[this->selected[i]].name, results[i].ms_took);
+            }
+        }
+
+        void run_parallel(unsigned jobs) {
+            const auto& cases = gech::registry();
+            const auto& selected = this->selected;
+
+            if(jobs > selected.size())
+                jobs = selected.size();
+
+            std::vector<gech::work_queue> queues(jobs);
+            std::vector<gech::case_result> results(selected.size());
+            std::vector<std::thread> workers;
+
+            for(std::size_t i = 0; i < selected.size(); ++i)
+                queues[i % jobs].cases.push_back(i);
+
+            for(unsigned id = 0; id < jobs; ++id) {
+                workers.emplace_back([this, &cases, &selected, &queues, &results, jobs, id] {
+                    gech::test worker;
+                    worker.inherit(*this);
+                    gech::current_test = &worker;
+
+                    std::size_t index;
+
+                    while(true) {
+                        bool found = queues[id].pop(index);
+
+                        for(unsigned victim = 1; !found && victim < jobs; ++victim)
+                            found = queues[(id + victim) % jobs].steal(index);
+
+                        if(!found)
+                            break;
+
+                        const auto ms_took = worker.run_case(cases[selected[index]], index);
+                        worker.take_result(results[index]);
+                        results[index].ms_took = ms_took;
+                    }
+
+                    gech::current_test = nullptr;
+                });
+            }
+
+            for(auto& worker : workers)
+                worker.join();
+
+            this->merge_results(results);
+        }
+
+        #ifdef GECHTEST_HAS_FORK
+            void run_isolated(unsigned jobs) {
+                const auto& selected = this->selected;
+
+                if(jobs > selected.size())
+                    jobs = std::max<std::size_t>(selected.size(), 1);
+
+                std::vector<gech::worker_process> workers(jobs);
+                std::vector<gech::case_result> results(selected.size());
+
+                for(std::size_t i = 0; i < selected.size(); ++i)
+                    workers[i % jobs].shard.push_back(i);
+
+                // this thread alone writes from here on, workers fork a
+                // single-threaded process.
+                gech::writer().join_thread();
+
+                for(auto& worker : workers)
+                    this->spawn_worker(worker, workers);
+
+                std::vector<pollfd> fds;
+                std::vector<gech::worker_process*> polled;
+
+                while(true) {
+                    fds.clear();
+                    polled.clear();
+
+                    for(auto& worker : workers) {
+                        if(worker.results >= 0) {
+                            fds.push_back({worker.results, POLLIN, 0});
+                            polled.push_back(&worker);
+                        }
+                    }
+
+                    if(fds.empty())
+                        break;
+
+                    if(::poll(fds.data(), fds.size(), -1) < 0) {
+                        if(errno == EINTR)
+                            continue;
+                        break;
+                    }
+
+                    for(std::size_t i = 0; i < fds.size(); ++i) {
+                        if(fds[i].revents == 0)
+                            continue;
+
+                        auto& worker = *polled[i];
+
+                        if(!this->receive_result(worker, results))
+                            this->reap_worker(worker, workers, results);
+
+                        gech::writer().sync();
+                    }
+                }
+
+                this->merge_results(results);
+            }
+
+            void spawn_worker(gech::worker_process& worker, std::vector<gech::worker_process>& workers) {
+                int tasks[2], results[2];
+
+                if(::pipe(tasks) < 0 || ::pipe(results) < 0) {
+                    std::perror("gechtest: pipe");
+                    std::abort();
+                }
+
+                std::cout.flush();
+                const auto pid = ::fork();
+
+                if(pid < 0) {
+                    std::perror("gechtest: fork");
+                    std::abort();
+                }
+
+                if(pid == 0) {
+                    for(auto& other : workers) {
+                        if(other.results >= 0)
+                            ::close(other.results);
+                    }
+
+                    ::close(tasks[1]);
+                    ::close(results[0]);
+                    this->worker_main(tasks[0], results[1]);
+                }
+
+                ::close(tasks[0]);
+                ::close(results[1]);
+
+                const std::uint32_t count = worker.shard.size() - worker.next;
+
+                gech::write_all(tasks[1], &count, sizeof(count));
+                gech::write_all(tasks[1], worker.shard.data() + worker.next, count * sizeof(std::uint32_t));
+                ::close(tasks[1]);
+
+                worker.pid = pid;
+                worker.results = results[0];
+            }
+
+            [[noreturn]] void worker_main(int tasks, int results) {
+                const auto& cases = gech::registry();
+
+                std::uint32_t count = 0;
+                gech::read_all(tasks, &count, sizeof(count));
+
+                std::vector<std::uint32_t> shard(count);
+                gech::read_all(tasks, shard.data(), count * sizeof(std::uint32_t));
+                ::close(tasks);
+
+                gech::test worker;
+                worker.inherit(*this);
+                std::vector<gech::record> records;
+                worker.capture = &records;
+                gech::current_test = &worker;
+                gech::default_owner = &worker;
+
+                gech::case_result result;
+                std::string text;
+
+                for(const auto index : shard) {
+                    const auto ms_took = worker.run_case(cases[this->selected[index]], index);
+                    worker.take_result(result);
+                    std::cout.flush();
+
+                    // literals are at the same address in the parent, kept text is not.
+                    text.clear();
+
+                    for(const auto& entry : records) {
+                        if(entry.kept)
+                            text += entry.data;
+                    }
+
+                    gech::result_header header {
+                        ms_took, index, result.errors, result.passes, result.rc,
+                        static_cast<std::uint32_t>(records.size()),
+                        static_cast<std::uint32_t>(result.benches.size()),
+                        static_cast<std::uint32_t>(result.perf.size()),
+                        static_cast<std::uint32_t>(result.baseline.size()),
+                        static_cast<std::uint32_t>(text.size()),
+                        result.current_location
+                    };
+
+                    if(!gech::write_all(results, &header, sizeof(header))
+                    || !gech::write_all(results, records.data(), records.size() * sizeof(gech::record))
+                    || !gech::write_all(results, result.benches.data(), result.benches.size() * sizeof(gech::bench_result))
+                    || !gech::write_all(results, result.perf.data(), result.perf.size() * sizeof(gech::perf_result))
+                    || !gech::write_all(results, result.baseline.data(), result.baseline.size() * sizeof(gech::baseline_entry))
+                    || !gech::write_all(results, text.data(), text.size()))
+                        ::_exit(1);
+
+                    for(const auto& entry : records)
+                        gech::writer().release(entry);
+
+                    records.clear();
+                }
+
+                ::_exit(0);
+            }
+
+            bool receive_result(gech::worker_process& worker, std::vector<gech::case_result>& results) {
+                gech::result_header header;
+
+                if(!gech::read_all(worker.results, &header, sizeof(header)) || header.index >= results.size())
+                    return false;
+
+                auto& result = results[header.index];
+                std::vector<gech::record> records(header.record_count);
+                result.benches.resize(header.bench_count);
+                result.perf.resize(header.perf_count);
+                result.baseline.resize(header.baseline_count);
+                std::string text(header.text_size, '\0');
+
+                if(!gech::read_all(worker.results, records.data(), header.record_count * sizeof(gech::record))
+                || !gech::read_all(worker.results, result.benches.data(), header.bench_count * sizeof(gech::bench_result))
+                || !gech::read_all(worker.results, result.perf.data(), header.perf_count * sizeof(gech::perf_result))
+                || !gech::read_all(worker.results, result.baseline.data(), header.baseline_count * sizeof(gech::baseline_entry))
+                || !gech::read_all(worker.results, text.data(), header.text_size))
+                    return false;
+
+                std::size_t offset = 0;
+
+                for(auto& entry : records) {
+                    if(entry.kept) {
+                        entry.data = gech::writer().keep(text.substr(offset, entry.data.size()));
+                        offset += entry.data.size();
+                    }
+
+                    gech::writer().push(entry);
+                }
+
+                result.errors = header.errors;
+                result.passes = header.passes;
+                result.ms_took = header.ms_took;
+                result.rc = header.rc;
+                result.current_location = header.current_location;
+                ++worker.next;
+                return true;
+            }
+
+            // the worker hung up: either it finished its shard, or the case at
+            // worker.next took it down. record that case and restart on the rest.
+            void reap_worker(gech::worker_process& worker, std::vector<gech::worker_process>& workers,
+                             std::vector<gech::case_result>& results) {
+                int status = 0;
+
+                ::close(worker.results);
+                worker.results = -1;
+                ::waitpid(worker.pid, &status, 0);
+
+                if(worker.next >= worker.shard.size())
+                    return;
+
+                const auto position = worker.shard[worker.next];
+                const auto& crashed = gech::registry()[this->selected[position]];
+                auto& result = results[position];
+                std::ostringstream buffer;
+
+                buffer << "Worker process running " << crashed.name;
+
+                if(WIFSIGNALED(status))
+                    buffer << " killed by signal " << WTERMSIG(status);
+                else
+                    buffer << " exited with status " << WEXITSTATUS(status);
+
+                // records only carry a view, keep the text alive for the writer.
+                gech::record entry;
+                entry.result = Critical;
+                entry.case_index = position;
+                entry.data = gech::writer().keep(buffer.str());
+                entry.kept = true;
+                entry.location = crashed.location;
+                entry.function = crashed.name;
+                gech::writer().push(entry);
+
+                entry.kind = CaseEnd;
+                entry.data = crashed.name;
+                gech::writer().push(entry);
+
+                result.errors = 1;
+                result.current_location = crashed.location;
+
+                if(++worker.next < worker.shard.size())
+                    this->spawn_worker(worker, workers);
+            }
+
+            // local stand-in for a distributed CI: re-executes this binary once
+            // per shard with GECHTEST_SHARD_INDEX / GECHTEST_TOTAL_SHARDS set,
+            // then prints each shard's output in order.
+            int launch_shards(const gech::options& opts) {
+                std::vector<pid_t> pids(opts.shards);
+                std::vector<std::FILE*> outputs(opts.shards);
+                const auto total = std::to_string(opts.shards);
+                unsigned failed = 0;
+
+                // every output first, a shard must not start without one.
+                for(unsigned i = 0; i < opts.shards; ++i) {
+                    outputs[i] = std::tmpfile();
+
+                    if(outputs[i] == nullptr) {
+                        std::perror("gechtest: shard output");
+
+                        for(unsigned j = 0; j < i; ++j)
+                            std::fclose(outputs[j]);
+
+                        return 2;
+                    }
+                }
+
+                std::cout.flush();
+
+                for(unsigned i = 0; i < opts.shards; ++i) {
+                    pids[i] = ::fork();
+
+                    if(pids[i] < 0) {
+                        std::perror("gechtest: fork");
+                        std::abort();
+                    }
+
+                    if(pids[i] == 0) {
+                        ::dup2(::fileno(outputs[i]), STDOUT_FILENO);
+                        ::setenv("GECHTEST_TOTAL_SHARDS", total.c_str(), 1);
+                        ::setenv("GECHTEST_SHARD_INDEX", std::to_string(i).c_str(), 1);
+                        ::setenv("GECHTEST_SEED", std::to_string(opts.seed).c_str(), 1);
+                        ::execv("/proc/self/exe", opts.argv);
+                        ::execvp(opts.argv[0], opts.argv);
+                        std::perror("gechtest: exec");
+                        ::_exit(127);
+                    }
+                }
+
+                for(unsigned i = 0; i < opts.shards; ++i) {
+                    int status = 0;
+                    char data[4096];
+
+                    ::waitpid(pids[i], &status, 0);
+
+                    if(!WIFEXITED(status) || WEXITSTATUS(status) != 0)
+                        ++failed;
+
+                    std::rewind(outputs[i]);
+
+                    while(const auto size = std::fread(data, 1, sizeof(data), outputs[i]))
+                        std::cout.write(data, size);
+
+                    std::fclose(outputs[i]);
+                }
+
+                if(!opts.timings.empty()) {
+                    for(unsigned i = 0; i < opts.shards; ++i) {
+                        const auto part = opts.timings + '.' + std::to_string(i);
+                        this->timings.load(part);
+                        std::remove(part.c_str());
+                    }
+
+                    this->timings.save(opts.timings);
+                }
+
+                if(!opts.baseline_write.empty()) {
+                    gech::baseline merged;
+                    merged.load(opts.baseline_write);
+
+                    for(unsigned i = 0; i < opts.shards; ++i) {
+                        const auto part = opts.baseline_write + '.' + std::to_string(i);
+                        merged.load(part);
+                        std::remove(part.c_str());
+                    }
+
+                    merged.save(opts.baseline_write);
+                }
+
+                std::cout << "\n[SHARDS]\n"
+                          << "Shard/s: "
+                          << opts.shards
+                          << '\n'
+                          << "Failed: "
+                          << failed
+                          << '\n';
+
+                return failed != 0 ? 1 : 0;
+            }
+        #else
+            void run_isolated(unsigned jobs) {
+                std::cerr << "gechtest: --isolate needs fork(), running in-process\n";
+
+                if(jobs > 1)
+                    this->run_parallel(jobs);
+                else {
+                    const auto& cases = gech::registry();
+
+                    for(std::size_t i = 0; i < this->selected.size(); ++i) {
+                        this->timings.record(cases[this->selected[i]].name, this->run_case(cases[this->selected[i]], i));
+                        gech::writer().sync();
+                    }
+                }
+            }
+        #endif
+
+        // settings a worker context copies from the context that runs it.
+        void inherit(const gech::test& owner) noexcept {
+            this->quiet = owner.quiet;
+            this->bench = owner.bench;
+            this->perf = owner.perf;
+            this->baseline_samples = owner.baseline_samples;
+            this->infos.cap = owner.infos.cap;
+            this->rc_infos.cap = owner.rc_infos.cap;
+            this->property_runs = owner.property_runs;
+            this->seed = owner.seed;
+            this->fuzz = owner.fuzz;
+            this->co_timeout_ms = owner.co_timeout_ms;
+            this->baseline_before = owner.baseline_before;
+            this->baseline_threshold = owner.baseline_threshold;
+        }
+
+        void take_result(gech::case_result& result) {
+            result.errors = this->errors;
+            result.passes = this->passes;
+            result.benches = std::move(this->benches);
+            result.perf = std::move(this->perf_results);
+            result.baseline = std::move(this->baseline_results);
+            result.rc = this->rc;
+            result.current_location = this->current_location;
+
+            this->errors = 0;
+            this->passes = 0;
+            this->rc = 0;
+            this->benches.clear();
+            this->perf_results.clear();
+            this->baseline_results.clear();
+        }
+
+        void merge_result(gech::case_result& result) {
+            this->errors += result.errors;
+            this->passes += result.passes;
+            this->benches.insert(this->benches.end(), result.benches.begin(), result.benches.end());
+            this->perf_results.insert(this->perf_results.end(), result.perf.begin(), result.perf.end());
+            this->baseline_results.insert(this->baseline_results.end(), result.baseline.begin(), result.baseline.end());
+            this->rc += result.rc;
+            this->current_location = result.current_location;
+        }
+
+        void test_function(function_test test) {
+            gech::test_log_node val;
+            val.func = test;
+            this->func = test;
+            this->infos.push_back(val);
+        }
+
+        void fill_infos(const std::source_location location = std::source_location::current()) {
+            this->line = location.line();
+            this->column = location.column();
+            this->file_name = location.file_name();
+            this->function_name = location.function_name();
+        }
+
+        const gech::test_log_node& put_log(const gech::test_results& result, const string message,
+                                           const bool kept = false) noexcept {
+            gech::test_log_node val;
+            val.result = result;
+            val.data = message;
+            val.kept = kept;
+            this->infos.push_back(val);
+            return this->infos.back();
+        }
+        void draw_case(const gech::test_log_node& node) {
+            if(node.result == Error)
+                ++this->errors;
+        }
+
+        template <typename... Val>
+        void put(const Val&... message) noexcept {
+            auto& info = this->infos.back();
+
+            this->draw_case(info);
+            this->put_record(info.result, info.data, info.ms_took, info.kept);
+
+            // kept text now belongs to the record and is freed with it, the
+            // node must not go on pointing at it.
+            if(info.kept)
+                info.data = string();
+        }
+
+        // console text is produced on the writer thread, this only queues a record.
+        void put_record(const gech::test_results result, const string data, const std::uint64_t ms_took,
+                        const bool kept = false) noexcept {
+            gech::record entry;
+            entry.result = result;
+            entry.case_index = this->case_index;
+            entry.ms_took = ms_took;
+            entry.data = data;
+            entry.kept = kept;
+            entry.location = this->current_location;
+
+            if(gech::same_location(this->current_location, this->case_location))
+                entry.function = this->case_name;
+
+            this->emit(entry);
+        }
+
+        bool quiet_pass() const noexcept {
+            #ifdef TEST_QUIET
+                return true;
+            #else
+                return this->quiet;
+            #endif
+        }
+
+        // passes are counted, never stored in infos; with TEST_QUIET (compile
+        // time) or --quiet the increment is all that happens. otherwise one
+        // record goes to the writer ring, which does not allocate.
+        void pass() noexcept {
+            if(this->probing)
+                return;
+
+            ++this->passes;
+
+            if(this->quiet_pass())
+                return;
+
+            this->put_record(Success, "OK", 0);
+        }
+
+        // failures keep their detail in infos, off the pass path.
+        void fail(const gech::test_results result, const string message, const bool kept = false) noexcept {
+            if(this->probing) {
+                ++this->falsified;
+                return;
+            }
+
+            this->put(this->put_log(result, message, kept).data);
+        }
+
+        // failure text outlives the case in the writer, unless it is thrown away anyway.
+        string keep(std::string text) {
+            if(this->probing)
+                return string();
+
+            // the writer frees it after the case ended, so the copy it keeps
+            // is made untracked; the case's own text is freed on return.
+            gech::alloc_pause pause;
+            return gech::writer().keep(std::string(text));
+        }
+
+        // the message with both operands printed, built only once a comparison failed.
+        template <typename Arg1, typename Arg2>
+        void fail_values(const string message, const Arg1& lhs, const Arg2& rhs) {
+            if(this->probing)
+                return this->fail(Error, message);
+
+            std::string text(message);
+            text += ": lhs = ";
+            gech::print_value(text, lhs);
+            text += ", rhs = ";
+            gech::print_value(text, rhs);
+            this->fail(Error, this->keep(std::move(text)), true);
+        }
+
+        // arrays (string literals mostly) compare as pointers, like they did by value.
+        template <typename Arg>
+        static constexpr decltype(auto) operand(const Arg& val) noexcept {
+            if constexpr(std::is_array_v<Arg>)
+                return static_cast<const std::remove_extent_t<Arg>*>(val);
+            else
+                return (val);
+        }
+
+        template <gech::test_types Type, typename Arg1, typename Arg2>
+        static constexpr bool compare(const Arg1& val, const Arg2& val2) {
+            if constexpr(Type == Eq)
+                return val == val2;
+            else if constexpr(Type == UnEq)
+                return val != val2;
+            else if constexpr(Type == Gt)
+                return val > val2;
+            else if constexpr(Type == Lt)
+                return val < val2;
+            else if constexpr(Type == GEq)
+                return val >= val2;
+            else
+                return val <= val2;
+        }
+
+        template <gech::test_types Type>
+        static constexpr string failure_message() noexcept {
+            if constexpr(Type == Eq)
+                return "Given values are not equal, expected equal";
+            else if constexpr(Type == UnEq)
+                return "Given values are equal, expected not equal";
+            else if constexpr(Type == Gt)
+                return "Given values are not greater, expected greater";
+            else if constexpr(Type == Lt)
+                return "Given values are greater, expected not greater";
+            else if constexpr(Type == GEq)
+                return "Given values are not greater or equal, expected greater or equal";
+            else
+                return "Given values are greater or equal, expected not greater or equal";
+        }
+
+        // the comparison kind is a template argument, so every ASSERT_* expands
+        // to one inlined compare with its failure message fixed at compile time.
+        template <gech::test_types Type, typename Arg1, typename Arg2>
+        void assert(const Arg1& lhs, const Arg2& rhs,
+                    const std::source_location location = std::source_location::current()) {
+            static_assert(Type != MemLeak, "MemLeak is not a value comparison");
+
+            gech::alloc_pause pause;
+            this->current_location = location;
+
+            if(compare<Type>(operand(lhs), operand(rhs))) [[likely]]
+                this->pass();
+            else
+                this->fail_values(failure_message<Type>(), lhs, rhs);
+        }
+
+        // index of the first element that differs, count if none do. contiguous
+        // ranges of the same type with no padding bits go through first_mismatch;
+        // floating point elements there are equal when bitwise equal or ==.
+        template <typename Range1, typename Range2>
+        static std::size_t range_mismatch(const Range1& lhs, const Range2& rhs, const std::size_t count) {
+            using value = std::ranges::range_value_t<const Range1>;
+
+            if constexpr(std::ranges::contiguous_range<const Range1> && std::ranges::contiguous_range<const Range2>
+                      && std::is_same_v<value, std::ranges::range_value_t<const Range2>>
+                      && (std::has_unique_object_representations_v<value> || std::is_floating_point_v<value>)) {
+                const auto a = std::ranges::data(lhs);
+                const auto b = std::ranges::data(rhs);
+
+                for(std::size_t from = 0;;) {
+                    const auto index = from + gech::first_mismatch(a + from, b + from, (count - from) * sizeof(value)) / sizeof(value);
+
+                    if constexpr(std::is_floating_point_v<value>) {
+                        if(index != count && a[index] == b[index]) {
+                            from = index + 1;
+                            continue;
+                        }
+                    }
+
+                    return index;
+                }
+            } else {
+                const auto [a, b] = std::ranges::mismatch(lhs, rhs);
+                return static_cast<std::size_t>(std::ranges::distance(std::ranges::begin(lhs), a));
+            }
+        }
+
+        // "[a, b, c]" of range elements [from, to).
+        template <typename Range>
+        static void print_window(std::string& text, const Range& range, const std::size_t from, const std::size_t to) {
+            auto at = std::ranges::next(std::ranges::begin(range), from);
+
+            text += '[';
+
+            for(auto i = from; i < to; ++i, ++at) {
+                if(i != from)
+                    text += ", ";
+
+                gech::print_value(text, *at);
+            }
+
+            text += ']';
+        }
+
+        // elements shown on each side of the first mismatch.
+        static constexpr std::size_t diff_window = 4;
+
+        // one assertion for the whole range, however long.
+        template <typename Range1, typename Range2>
+        void assert_range_eq(const Range1& lhs, const Range2& rhs,
+                             const std::source_location location = std::source_location::current()) {
+            gech::alloc_pause pause;
+            this->current_location = location;
+
+            const auto count = static_cast<std::size_t>(std::ranges::distance(lhs));
+            const auto rhs_count = static_cast<std::size_t>(std::ranges::distance(rhs));
+
+            if(count == rhs_count) [[likely]] {
+                const auto index = range_mismatch(lhs, rhs, count);
+
+                if(index == count) [[likely]] {
+                    this->pass();
+                    return;
+                }
+
+                const auto from = index - std::min(index, diff_window);
+                const auto to = std::min(count, index + diff_window + 1);
+
+                std::string text = "Given ranges are not equal, expected equal: first mismatch at index ";
+                gech::append_number(text, index);
+                text += ", lhs[";
+                gech::append_number(text, from);
+                text += "..";
+                gech::append_number(text, to);
+                text += ") = ";
+                print_window(text, lhs, from, to);
+                text += ", rhs[";
+                gech::append_number(text, from);
+                text += "..";
+                gech::append_number(text, to);
+                text += ") = ";
+                print_window(text, rhs, from, to);
+                this->fail(Error, this->keep(std::move(text)), true);
+                return;
+            }
+
+            std::string text = "Given ranges differ in size, expected equal: lhs has ";
+            gech::append_number(text, count);
+            text += ", rhs has ";
+            gech::append_number(text, rhs_count);
+            this->fail(Error, this->keep(std::move(text)), true);
+        }
+
+        void assert_bytes_eq(const void* lhs, const void* rhs, const std::size_t size,
+                             const std::source_location location = std::source_location::current()) {
+            gech::alloc_pause pause;
+            this->current_location = location;
+
+            const auto index = gech::first_mismatch(lhs, rhs, size);
+
+            if(index == size) [[likely]] {
+                this->pass();
+                return;
+            }
+
+            static constexpr char hex[] = "0123456789abcdef";
+            const auto from = index - std::min<std::size_t>(index, 2 * diff_window);
+            const auto to = std::min(size, index + 2 * diff_window + 1);
+
+            const auto window = [&](std::string& text, const void* bytes) {
+                text += '[';
+
+                for(auto i = from; i < to; ++i) {
+                    const auto byte = static_cast<const unsigned char*>(bytes)[i];
+
+                    if(i != from)
+                        text += ' ';
+
+                    text += hex[byte >> 4];
+                    text += hex[byte & 0xf];
+                }
+
+                text += ']';
+            };
+
+            std::string text = "Given buffers are not equal, expected equal: first mismatch at byte ";
+            gech::append_number(text, index);
+            text += ", lhs[";
+            gech::append_number(text, from);
+            text += "..";
+            gech::append_number(text, to);
+            text += ") = ";
+            window(text, lhs);
+            text += ", rhs[";
+            gech::append_number(text, from);
+            text += "..";
+            gech::append_number(text, to);
+            text += ") = ";
+            window(text, rhs);
+            this->fail(Error, this->keep(std::move(text)), true);
+        }
+
+        template <gech::tolerance_kinds Kind>
+        static constexpr string tolerance_label() noexcept {
+            if constexpr(Kind == Absolute)
+                return "absolute error";
+            else if constexpr(Kind == Relative)
+                return "relative error";
+            else
+                return "ulp distance";
+        }
+
+        // "expected absolute error <= 0.001" and so on.
+        template <gech::tolerance_kinds Kind>
+        static void append_tolerance(std::string& text, const double tolerance) {
+            text += ", expected ";
+            text += tolerance_label<Kind>();
+            text += " <= ";
+            gech::print_value(text, tolerance);
+        }
+
+        // float when both operands are, so ulps are float ulps; double otherwise.
+        template <typename Arg1, typename Arg2>
+        using near_type = std::conditional_t<std::is_same_v<std::common_type_t<Arg1, Arg2>, float>, float, double>;
+
+        template <gech::tolerance_kinds Kind, typename Arg1, typename Arg2>
+        void assert_close(const Arg1& lhs, const Arg2& rhs, const double tolerance,
+                          const std::source_location location = std::source_location::current()) {
+            using Float = near_type<Arg1, Arg2>;
+
+            gech::alloc_pause pause;
+            this->current_location = location;
+
+            const auto a = static_cast<Float>(lhs), b = static_cast<Float>(rhs);
+
+            if(gech::near<Kind>(a, b, tolerance)) [[likely]] {
+                this->pass();
+                return;
+            }
+
+            // nan against nan, or rounding that only the double check forgives.
+            const auto error = gech::near_error<Kind>(a, b);
+
+            if(error <= tolerance) {
+                this->pass();
+                return;
+            }
+
+            std::string text = "Given values are not near";
+            append_tolerance<Kind>(text, tolerance);
+            text += ": lhs = ";
+            gech::print_value(text, a);
+            text += ", rhs = ";
+            gech::print_value(text, b);
+            text += ", error = ";
+            gech::print_value(text, error);
+            this->fail(Error, this->keep(std::move(text)), true);
+        }
+
+        // the whole span is one assertion. all_near() decides the common case;
+        // only when it finds something does the scalar pass below run, which
+        // counts, finds the worst element and buckets every error by its
+        // ratio to the tolerance.
+        template <gech::tolerance_kinds Kind, typename Range1, typename Range2>
+        void assert_array_close(const Range1& lhs, const Range2& rhs, const double tolerance,
+                                const std::source_location location = std::source_location::current()) {
+            using Float = std::ranges::range_value_t<const Range1>;
+
+            static_assert(std::ranges::contiguous_range<const Range1> && std::ranges::contiguous_range<const Range2>
+                       && std::is_same_v<Float, std::ranges::range_value_t<const Range2>>
+                       && (std::is_same_v<Float, float> || std::is_same_v<Float, double>),
+                          "array tolerance assertions take contiguous float or double ranges of one type");
+
+            gech::alloc_pause pause;
+            this->current_location = location;
+
+            const auto count = static_cast<std::size_t>(std::ranges::size(lhs));
+
+            if(count != static_cast<std::size_t>(std::ranges::size(rhs))) {
+                std::string text = "Given arrays differ in size, expected equal: lhs has ";
+                gech::append_number(text, count);
+                text += ", rhs has ";
+                gech::append_number(text, static_cast<std::size_t>(std::ranges::size(rhs)));
+                this->fail(Error, this->keep(std::move(text)), true);
+                return;
+            }
+
+            const auto a = std::ranges::data(lhs);
+            const auto b = std::ranges::data(rhs);
+
+            if(gech::all_near<Kind>(a, b, count, tolerance)) [[likely]] {
+                this->pass();
+                return;
+            }
+
+            static constexpr const char* buckets[] = { "0", "<=1/4", "<=1/2", "<=1", "<=2", "<=4", "<=16", ">16" };
+            static constexpr double limits[] = { 0, 0.25, 0.5, 1, 2, 4, 16 };
+
+            std::array<std::size_t, std::size(buckets)> histogram {};
+            std::size_t far = 0, worst = 0;
+            double max_error = -1;
+
+            for(std::size_t i = 0; i < count; ++i) {
+                const auto error = gech::near_error<Kind>(a[i], b[i]);
+                const auto ratio = tolerance > 0 ? error / tolerance : error == 0 ? 0 : HUGE_VAL;
+
+                ++histogram[std::lower_bound(std::begin(limits), std::end(limits), ratio) - std::begin(limits)];
+                far += error > tolerance;
+
+                if(error > max_error) {
+                    max_error = error;
+                    worst = i;
+                }
+            }
+
+            if(far == 0) {
+                this->pass();
+                return;
+            }
+
+            std::string text = "Given arrays are not near";
+            append_tolerance<Kind>(text, tolerance);
+            text += ": ";
+            gech::append_number(text, far);
+            text += " of ";
+            gech::append_number(text, count);
+            text += " off, max error ";
+            gech::print_value(text, max_error);
+            text += " at index ";
+            gech::append_number(text, worst);
+            text += " (lhs = ";
+            gech::print_value(text, a[worst]);
+            text += ", rhs = ";
+            gech::print_value(text, b[worst]);
+            text += "), error/tolerance histogram: ";
+
+            for(std::size_t i = 0, shown = 0; i < histogram.size(); ++i) {
+                if(histogram[i] == 0)
+                    continue;
+
+                if(shown++ != 0)
+                    text += ", ";
+
+                text += buckets[i];
+                text += ": ";
+                gech::append_number(text, histogram[i]);
+            }
+
+            this->fail(Error, this->keep(std::move(text)), true);
+        }
+
+        template <typename Arg1, typename Arg2>
+        void assert_near(const Arg1& val, const Arg2& val2, const double tolerance,
+                         const std::source_location location = std::source_location::current()) {
+            this->assert_close<Absolute>(val, val2, tolerance, location);
+        }
+
+        template <typename Arg1, typename Arg2>
+        void assert_near_rel(const Arg1& val, const Arg2& val2, const double tolerance,
+                             const std::source_location location = std::source_location::current()) {
+            this->assert_close<Relative>(val, val2, tolerance, location);
+        }
+
+        template <typename Arg1, typename Arg2>
+        void assert_ulp_eq(const Arg1& val, const Arg2& val2, const std::uint64_t ulps,
+                           const std::source_location location = std::source_location::current()) {
+            this->assert_close<Ulp>(val, val2, static_cast<double>(ulps), location);
+        }
+
+        template <typename Range1, typename Range2>
+        void assert_array_near(const Range1& val, const Range2& val2, const double tolerance,
+                               const std::source_location location = std::source_location::current()) {
+            this->assert_array_close<Absolute>(val, val2, tolerance, location);
+        }
+
+        template <typename Range1, typename Range2>
+        void assert_array_near_rel(const Range1& val, const Range2& val2, const double tolerance,
+                                   const std::source_location location = std::source_location::current()) {
+            this->assert_array_close<Relative>(val, val2, tolerance, location);
+        }
+
+        template <typename Range1, typename Range2>
+        void assert_array_ulp_eq(const Range1& val, const Range2& val2, const std::uint64_t ulps,
+                                 const std::source_location location = std::source_location::current()) {
+            this->assert_array_close<Ulp>(val, val2, static_cast<double>(ulps), location);
+        }
+
+        template <typename Arg1, typename Arg2>
+        void assert(const gech::test_types& type, const Arg1& lhs, const Arg2& rhs,
+                    const std::source_location location = std::source_location::current()) {
+            switch(type) {
+                case Eq: this->assert<Eq>(lhs, rhs, location); break;
+                case UnEq: this->assert<UnEq>(lhs, rhs, location); break;
+                case Gt: this->assert<Gt>(lhs, rhs, location); break;
+                case Lt: this->assert<Lt>(lhs, rhs, location); break;
+                case GEq: this->assert<GEq>(lhs, rhs, location); break;
+                case LEq: this->assert<LEq>(lhs, rhs, location); break;
+                default: break;
+            }
+        }
+
+        void assert_rc(const std::source_location location = std::source_location::current()) {
+            gech::alloc_pause pause;
+
+            if(this->rc < 0) {
+                // a fuzz input that gets here crashed, the fuzzer restores rc after it.
+                if(this->probing) {
+                    ++this->falsified;
+                    return;
+                }
+
+                this->put(this->put_log(Critical, "(RC < 0) Deallocating not allocated value").data, location);
+                this->summary();
+                std::abort();
+            }
+        }
+
+        template <typename Arg1, typename Arg2>
+        void assert_eq(const Arg1& val, const Arg2& val2, const std::source_location location = std::source_location::current()) {
+            this->assert<Eq>(val, val2, location);
+        }
+
+        template <typename Arg1, typename Arg2>
+        void assert_uneq(const Arg1& val, const Arg2& val2, const std::source_location location = std::source_location::current()) {
+            this->assert<UnEq>(val, val2, location);
+        }
+
+        template <typename Arg1, typename Arg2>
+        void assert_gt(const Arg1& val, const Arg2& val2, const std::source_location location = std::source_location::current()) {
+            this->assert<Gt>(val, val2, location);
+        }
+
+        template <typename Arg1, typename Arg2>
+        void assert_lt(const Arg1& val, const Arg2& val2, const std::source_location location = std::source_location::current()) {
+            this->assert<Lt>(val, val2, location);
+        }
+
+        template <typename Arg1, typename Arg2>
+        void assert_geq(const Arg1& val, const Arg2& val2, const std::source_location location = std::source_location::current()) {
+            this->assert<GEq>(val, val2, location);
+        }
+
+        template <typename Arg1, typename Arg2>
+        void assert_leq(const Arg1& val, const Arg2& val2, const std::source_location location = std::source_location::current()) {
+            this->assert<LEq>(val, val2, location);
+        }
+    };
+}
+
+namespace gech {
+    inline test test_reg;
+
+    // a thread the test body started asserts into a test of its own, so it
+    // never writes the counters, logs or location of the case. what it
+    // gathered goes to the case when the thread exits or moves on to
+    // another case; threads have to finish (be joined) before the body
+    // returns for their results to land in that case.
+    class thread_context {
+    public:
+        test state;
+        std::vector<record> records;
+
+        test* owner = nullptr;
+        std::uint64_t run = 0;
+    public:
+        thread_context() = default;
+
+        ~thread_context() {
+            this->publish();
+        }
+
+        test& bind(test& owner) {
+            if(this->owner != &owner || this->run != owner.runs) {
+                this->publish();
+
+                this->owner = &owner;
+                this->run = owner.runs;
+                this->state.inherit(owner);
+                this->state.owner = &owner;
+                this->state.case_index = owner.case_index;
+                this->state.capture = &this->records;
+            }
+
+            return this->state;
+        }
+
+        void publish() {
+            if(this->owner == nullptr)
+                return;
+
+            if(this->state.errors != 0 || this->state.passes != 0 || this->state.rc != 0 || !this->records.empty()) {
+                gech::alloc_pause pause;
+
+                auto result = new gech::thread_result;
+                result->errors = this->state.errors;
+                result->passes = this->state.passes;
+                result->rc = this->state.rc;
+                result->records = std::move(this->records);
+                this->owner->adopt(result);
+            }
+
+            this->state.errors = 0;
+            this->state.passes = 0;
+            this->state.rc = 0;
+            this->state.infos.clear();
+            this->state.rc_infos.clear();
+            this->records.clear();
+        }
+    };
+
+    inline test& context() {
+        if(current_test != nullptr)
+            return *current_test;
+
+        const auto owner = thread_owner != nullptr ? thread_owner : default_owner;
+
+        if(owner == nullptr)
+            return test_reg;
+
+        thread_local gech::thread_context local;
+        return local.bind(*owner);
+    }
+
+    // std::thread that reports into the test it was started from, which
+    // under -j is the only way to tell which case a thread belongs to. with
+    // TEST_TRACK_ALLOC its allocations count towards that case too.
+    class thread : public std::thread {
+    public:
+        thread() noexcept = default;
+
+        template <typename Func, typename... Args>
+        explicit thread(Func&& func, Args&&... args)
+            : std::thread([owner = &gech::thread::owning(), scope = gech::alloc_current,
+                           func = std::forward<Func>(func)](auto&&... args) mutable {
+                  gech::thread_owner = owner;
+                  gech::alloc_current = scope;
+                  std::invoke(func, std::forward<decltype(args)>(args)...);
+              }, std::forward<Args>(args)...) {}
+
+        thread(thread&&) noexcept = default;
+        thread& operator=(thread&&) noexcept = default;
+
+        ~thread() = default;
+    private:
+        static test& owning() {
+            auto& current = gech::context();
+            return current.owner != nullptr ? *current.owner : current;
+        }
+    };
+}
+
+using gech::test_reg;
+
+#define TEST(case_name) \
+    void case_name();  \
+    static gech::test_register case_name##_register(#case_name, case_name);\
+    void case_name()
+
+// TYPED_TEST(name, int, float, ...) registers name<int>, name<float>, ...;
+// the body is a template over TypeParam.
+#define TYPED_TEST(case_name, ...) \
+    template <typename TypeParam> void case_name(); \
+    static gech::typed_register<__VA_ARGS__> case_name##_register(#case_name, \
+        [](auto type) -> gech::function_test { return &case_name<typename decltype(type)::type>; });\
+    template <typename TypeParam> void case_name()
+
+// PROPERTY(name, gech::gen::integer(0, 100), gech::gen::vector(gech::gen::integer<int>()))
+// runs the body with args, a tuple of one generated value per generator:
+// const auto& [count, items] = args;
+#define PROPERTY(case_name, ...) \
+    static const auto case_name##_gens = std::make_tuple(__VA_ARGS__); \
+    using case_name##_args = gech::property_args<decltype(case_name##_gens)>; \
+    void case_name(const case_name##_args& args); \
+    static void case_name##_property() { TEST_DATA.run_property(#case_name, case_name, case_name##_gens); } \
+    static gech::test_register case_name##_register(#case_name, case_name##_property);\
+    void case_name([[maybe_unused]] const case_name##_args& args)
+
+// FUZZ_TEST(name, const std::uint8_t* data, std::size_t size) runs the body
+// on its corpus, or fuzzes it with --fuzz; see test::run_fuzz().
+#define FUZZ_TEST(case_name, ...) \
+    void case_name(__VA_ARGS__); \
+    static void case_name##_fuzz() { TEST_DATA.run_fuzz(#case_name, case_name); } \
+    static gech::test_register case_name##_register(#case_name, case_name##_fuzz);\
+    void case_name(__VA_ARGS__)
+
+// CO_TEST(name) bodies are coroutines returning gech::task<>, so they need
+// a co_await or co_return. they can await gech::sleep_for(), gech::yield(),
+// a gech::event or any gech::task<T>; consecutive ones in a serial run are
+// interleaved on one thread, so their waits overlap. each fails when it
+// throws, or after --co-timeout ms (ms with CO_TEST_TIMEOUT(name, ms)).
+#define CO_TEST_TIMEOUT(case_name, ms) \
+    gech::task<> case_name(); \
+    static void case_name##_drive() { TEST_DATA.run_coroutine(case_name, ms); } \
+    static gech::test_register case_name##_register(#case_name, case_name##_drive, case_name, ms);\
+    gech::task<> case_name()
+
+#define CO_TEST(case_name) \
+    CO_TEST_TIMEOUT(case_name, 0)
+
+// TEST_P(name, 1, 16, 1024) registers name/0, name/1, ...; the body takes
+// the value as param, of its own type, picked at compile time.
+#define TEST_P(case_name, ...) \
+    static const auto case_name##_params = std::make_tuple(__VA_ARGS__); \
+    template <std::size_t Index, typename Param> \
+    void case_name(const Param& param); \
+    template <std::size_t Index> \
+    void case_name##_run() { case_name<Index>(std::get<Index>(case_name##_params)); } \
+    static gech::param_register<std::tuple_size_v<std::remove_const_t<decltype(case_name##_params)>>> \
+        case_name##_register(#case_name, \
+            [](auto index) -> gech::function_test { return &case_name##_run<decltype(index)::value>; });\
+    template <std::size_t Index, typename Param> \
+    void case_name([[maybe_unused]] const Param& param)
+
+
+// BENCH() registers like TEST(), its body is the measured iteration.
+#define BENCH_WARMUP(bench_name, warmup) \
+    void bench_name(); \
+    static void bench_name##_bench() { TEST_DATA.run_bench(#bench_name, bench_name, warmup); } \
+    static gech::test_register bench_name##_register(#bench_name, bench_name##_bench);\
+    void bench_name()
+
+#define BENCH(bench_name) \
+    BENCH_WARMUP(bench_name, TEST_DATA.bench.warmup)
+
+#define TEST_MAIN \
+    int main(int argc, char** argv) { \
+        return test_reg.run_tests(gech::options::parse(argc, argv)); \
+    }
+
+#define TEST_DATA gech::context()
+
+#define ALLOC(name, type) \
+    TEST_DATA.assert_rc(); \
+    ++TEST_DATA.rc;        \
+    type* name = new type;
+
+#define DEALLOC(name) \
+    --TEST_DATA.rc;    \
+    TEST_DATA.assert_rc(); \
+    delete name;
+
+#define ASSERT_EQ(val, val2) \
+    TEST_DATA.assert_eq(val, val2);
+
+#define ASSERT_UNEQ(val, val2) \
+    TEST_DATA.assert_uneq(val, val2);
+
+#define ASSERT_GT(val, val2) \
+    TEST_DATA.assert_gt(val, val2);
+
+#define ASSERT_LT(val, val2) \
+    TEST_DATA.assert_lt(val, val2);
+
+#define ASSERT_GEQ(val, val2) \
+    TEST_DATA.assert_geq(val, val2);
 
 #define ASSERT_LEQ(val, val2) \
-    test_reg.assert_leq(val, val2);
+    TEST_DATA.assert_leq(val, val2);
+
+#define ASSERT_RANGE_EQ(val, val2) \
+    TEST_DATA.assert_range_eq(val, val2);
+
+#define ASSERT_BYTES_EQ(val, val2, size) \
+    TEST_DATA.assert_bytes_eq(val, val2, size);
+
+#define ASSERT_NEAR(val, val2, tolerance) \
+    TEST_DATA.assert_near(val, val2, tolerance);
+
+#define ASSERT_NEAR_REL(val, val2, tolerance) \
+    TEST_DATA.assert_near_rel(val, val2, tolerance);
+
+#define ASSERT_ULP_EQ(val, val2, ulps) \
+    TEST_DATA.assert_ulp_eq(val, val2, ulps);
+
+#define ASSERT_ARRAY_NEAR(val, val2, tolerance) \
+    TEST_DATA.assert_array_near(val, val2, tolerance);
+
+#define ASSERT_ARRAY_NEAR_REL(val, val2, tolerance) \
+    TEST_DATA.assert_array_near_rel(val, val2, tolerance);
+
+#define ASSERT_ARRAY_ULP_EQ(val, val2, ulps) \
+    TEST_DATA.assert_array_ulp_eq(val, val2, ulps);
+
+#ifdef TEST_TRACK_ALLOC
+    GECHTEST_NOINLINE void* operator new(std::size_t size) {
+        if(const auto pointer = gech::tracked_alloc(size, alignof(std::max_align_t), GECHTEST_RETURN_ADDRESS()))
+            return pointer;
+
+        throw std::bad_alloc();
+    }
+
+    GECHTEST_NOINLINE void* operator new[](std::size_t size) {
+        if(const auto pointer = gech::tracked_alloc(size, alignof(std::max_align_t), GECHTEST_RETURN_ADDRESS()))
+            return pointer;
+
+        throw std::bad_alloc();
+    }
+
+    GECHTEST_NOINLINE void* operator new(std::size_t size, std::align_val_t align) {
+        if(const auto pointer = gech::tracked_alloc(size, static_cast<std::size_t>(align), GECHTEST_RETURN_ADDRESS()))
+            return pointer;
+
+        throw std::bad_alloc();
+    }
+
+    GECHTEST_NOINLINE void* operator new[](std::size_t size, std::align_val_t align) {
+        if(const auto pointer = gech::tracked_alloc(size, static_cast<std::size_t>(align), GECHTEST_RETURN_ADDRESS()))
+            return pointer;
+
+        throw std::bad_alloc();
+    }
+
+    GECHTEST_NOINLINE void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+        return gech::tracked_alloc(size, alignof(std::max_align_t), GECHTEST_RETURN_ADDRESS());
+    }
+
+    GECHTEST_NOINLINE void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+        return gech::tracked_alloc(size, alignof(std::max_align_t), GECHTEST_RETURN_ADDRESS());
+    }
+
+    void operator delete(void* pointer) noexcept { gech::tracked_free(pointer); }
+    void operator delete[](void* pointer) noexcept { gech::tracked_free(pointer); }
+    void operator delete(void* pointer, std::size_t) noexcept { gech::tracked_free(pointer); }
+    void operator delete[](void* pointer, std::size_t) noexcept { gech::tracked_free(pointer); }
+    void operator delete(void* pointer, std::align_val_t) noexcept { gech::tracked_free(pointer); }
+    void operator delete[](void* pointer, std::align_val_t) noexcept { gech::tracked_free(pointer); }
+    void operator delete(void* pointer, std::size_t, std::align_val_t) noexcept { gech::tracked_free(pointer); }
+    void operator delete[](void* pointer, std::size_t, std::align_val_t) noexcept { gech::tracked_free(pointer); }
+    void operator delete(void* pointer, const std::nothrow_t&) noexcept { gech::tracked_free(pointer); }
+    void operator delete[](void* pointer, const std::nothrow_t&) noexcept { gech::tracked_free(pointer); }
+
+    #ifdef GECHTEST_TRACK_MALLOC
+        // blocks from before the wrap (or from inside libc) carry no header,
+        // the magic tells them apart.
+        extern "C" GECHTEST_NOINLINE void* __wrap_malloc(std::size_t size) {
+            return gech::tracked_alloc(size, alignof(std::max_align_t), GECHTEST_RETURN_ADDRESS());
+        }
+
+        extern "C" GECHTEST_NOINLINE void* __wrap_calloc(std::size_t count, std::size_t size) {
+            if(size != 0 && count > SIZE_MAX / size)
+                return nullptr;
+
+            const auto pointer = gech::tracked_alloc(count * size, alignof(std::max_align_t), GECHTEST_RETURN_ADDRESS());
+
+            if(pointer != nullptr)
+                std::memset(pointer, 0, count * size);
+
+            return pointer;
+        }
+
+        extern "C" void __wrap_free(void* pointer) {
+            if(pointer != nullptr && gech::header_of(pointer)->magic != gech::alloc_header::tracked)
+                __real_free(pointer);
+            else
+                gech::tracked_free(pointer);
+        }
+
+        extern "C" GECHTEST_NOINLINE void* __wrap_realloc(void* pointer, std::size_t size) {
+            if(pointer != nullptr && gech::header_of(pointer)->magic != gech::alloc_header::tracked)
+                return __real_realloc(pointer, size);
+
+            const auto moved = gech::tracked_alloc(size, alignof(std::max_align_t), GECHTEST_RETURN_ADDRESS());
+
+            if(moved != nullptr && pointer != nullptr) {
+                std::memcpy(moved, pointer, std::min(size, gech::header_of(pointer)->size));
+                gech::tracked_free(pointer);
+            }
+
+            return moved;
+        }
+    #endif
+#endif
+
+#ifdef TEST_FUZZ
+    // -fsanitize-coverage=trace-pc-guard, one guard per edge.
+    extern "C" GECHTEST_NO_COVERAGE void __sanitizer_cov_trace_pc_guard_init(std::uint32_t* start, std::uint32_t* stop) {
+        if(start == stop || *start != 0)
+            return;
+
+        for(auto guard = start; guard < stop; ++guard)
+            *guard = 1 + gech::coverage.guards++ % (gech::coverage_map::size - 1);
+    }
+
+    extern "C" GECHTEST_NO_COVERAGE void __sanitizer_cov_trace_pc_guard(std::uint32_t* guard) {
+        gech::cover(*guard);
+    }
+
+    // gcc's -fsanitize-coverage=trace-pc only passes blocks, edges come from
+    // the previous block like afl does.
+    extern "C" GECHTEST_NO_COVERAGE void __sanitizer_cov_trace_pc() {
+        thread_local std::uintptr_t previous = 0;
+
+        auto block = reinterpret_cast<std::uintptr_t>(__builtin_return_address(0));
+        block = (block ^ (block >> 15) ^ (block >> 31)) & (gech::coverage_map::size - 1);
+
+        gech::cover(block ^ previous);
+        previous = block >> 1;
+    }
+#endif
 
 #endif // GECHTEST_GECHTEST_HPP